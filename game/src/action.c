@@ -0,0 +1,44 @@
+/**********************************************************************************************
+*
+*   Action - Queue of unit actions
+*
+**********************************************************************************************/
+
+#include "action.h"
+
+//----------------------------------------------------------------------------------
+// Action Queue Functions Definition
+//----------------------------------------------------------------------------------
+// Returns false and drops the action if the queue is full.
+bool PushAction(ActionQueue* queue, Action action)
+{
+    if (queue->numActions == ACTION_QUEUE_SIZE)
+    {
+        return false;
+    }
+
+    queue->actions[(queue->first + queue->numActions) % ACTION_QUEUE_SIZE] = action;
+    queue->numActions++;
+
+    return true;
+}
+
+bool PopAction(ActionQueue* queue, Action* action)
+{
+    if (queue->numActions == 0)
+    {
+        return false;
+    }
+
+    *action = queue->actions[queue->first];
+    queue->first = (queue->first + 1) % ACTION_QUEUE_SIZE;
+    queue->numActions--;
+
+    return true;
+}
+
+void ClearActionQueue(ActionQueue* queue)
+{
+    queue->first = 0;
+    queue->numActions = 0;
+}
@@ -1,17 +1,39 @@
 #ifndef ACTION_H
 #define ACTION_H
 
+#include <stdbool.h>
+
 enum ActionType
 {
 	ACTION_MOVEMENT,
-	ACTION_ATTACK_BASIC
+	ACTION_ATTACK_BASIC,
+	ACTION_WAIT
 };
 
+// One turn of a unit, see ApplyAction().
 typedef struct Action
 {
 	int type;
+	int entity;					// Acting unit.
+	int tileIndex;				// Map tile to move to, the unit's own tile to stay in place.
+	int target;					// Entity to attack after moving, -1 if none.
 
 } Action;
 
-#endif
+#define ACTION_QUEUE_SIZE 64
+
+// Actions waiting for the simulation. Input, AI and replays all push here and the battle
+// applies whatever is queued once per update, in the order it was pushed.
+typedef struct ActionQueue
+{
+	Action actions[ACTION_QUEUE_SIZE];	// Ring buffer.
+	int first;
+	int numActions;
 
+} ActionQueue;
+
+bool PushAction(ActionQueue* queue, Action action);
+bool PopAction(ActionQueue* queue, Action* action);
+void ClearActionQueue(ActionQueue* queue);
+
+#endif
@@ -0,0 +1,863 @@
+/**********************************************************************************************
+*
+*   AI - Computer controlled units
+*
+*   Actions are picked for the active unit of a battle, through the same rules as the
+*   player's actions.
+*
+*   The search AI looks a few turns ahead with alpha-beta minimax and iterative deepening.
+*   It plays the turns out on the battle itself, moving units on the map and changing their
+*   health, and puts everything back before returning. Damage is the average of the attack
+*   roll, so the search never draws from the battle's random numbers.
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+
+#include "ai.h"
+#include "threads.h"
+
+#include <stdlib.h>
+#include <limits.h>
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+#define AI_UNIT_VALUE 50            // Worth of a living unit on top of its health.
+#define AI_DISTANCE_VALUE 1         // Cost of a tile between a unit that moved and the closest enemies.
+#define AI_APPROACH_ENEMIES 4       // Enemies closest to the unit that it walks towards.
+#define AI_WIN_SCORE 1000000
+#define AI_CLOCK_NODES 16           // Nodes searched between two looks at the clock.
+
+typedef struct AiMove
+{
+    Action action;
+    int order;                      // Searched first when higher.
+    int enemyDistance;              // Tiles to the closest enemies after the move.
+
+} AiMove;
+
+// Moves of one turn, sorted by order.
+typedef struct AiMoveList
+{
+    AiMove* moves;
+    int numMoves;
+    int maxMoves;
+    bool isComplete;                // Grows to hold every move instead of dropping the least promising.
+
+} AiMoveList;
+
+// Next turn of a unit, the search keeps its own turn order instead of the scheduler heap.
+typedef struct AiTurn
+{
+    int entity;
+    int time;
+    unsigned int order;
+
+} AiTurn;
+
+typedef struct AiSearch
+{
+    Battle* battle;
+    int team;                       // Plays for this team, every other team is an opponent.
+
+    AiTurn* turns;
+    int numTurns;
+    unsigned int nextOrder;
+
+    int score;                      // Health and units of the team minus those of the others.
+    int numUnits[BATTLE_TEAMS];
+
+    AiMove moves[AI_MAX_DEPTH][AI_MAX_MOVES];
+    int numNodes;
+    int maxNodes;
+    double endTime;                 // 0.0 without a time budget.
+    bool isAborted;
+
+} AiSearch;
+
+// What a searched action changed, to put it back.
+typedef struct AiUndo
+{
+    int fromTile;
+    int targetHealth;
+    unsigned char targetFlags;
+    int turn;
+    AiTurn turnBefore;
+
+} AiUndo;
+
+// Entity grid filter for the units the entity can attack.
+typedef struct AiTargets
+{
+    Battle* battle;
+    int entity;
+
+} AiTargets;
+
+//----------------------------------------------------------------------------------
+// AI Functions Definition
+//----------------------------------------------------------------------------------
+static bool IsAiTarget(void* data, int entity)
+{
+    AiTargets* targets = (AiTargets*)data;
+
+    return IsBattleTarget(targets->battle, targets->entity, entity);
+}
+
+static int GetTileDistance(Tile* a, Tile* b)
+{
+    int distanceX = abs(a->x - b->x);
+    int distanceZ = abs(a->z - b->z);
+
+    return (distanceX > distanceZ) ? distanceX : distanceZ;
+}
+
+// Hit the weakest enemy within reach, otherwise walk as close to an enemy as possible.
+Action ChooseGreedyAction(Battle* battle)
+{
+    int entity = battle->activeEntity;
+    Action action = { ACTION_WAIT, entity, -1, ENTITY_NONE };
+
+    if (entity == ENTITY_NONE)
+    {
+        return action;
+    }
+
+    Entities* entities = &battle->entities;
+    Pathfinder* pathfinder = &battle->pathfinder;
+    Tile* start = GetEntityTile(battle, entity);
+
+    FindReachableTiles(pathfinder, start, entities->infos[entity].speed);
+
+    // Reachable tiles come in order of cost, the first tile found next to a target is the
+    // closest one to attack it from.
+    int bestTarget = ENTITY_NONE;
+    Tile* bestTile = NULL;
+
+    for (int i = 0; i < pathfinder->numReachableTiles; i++)
+    {
+        Tile* tile = pathfinder->reachableTiles[i];
+
+        // Units can walk past the dead but not stop on them.
+        if (tile != start && tile->entity != ENTITY_NONE)
+        {
+            continue;
+        }
+
+        for (int z = tile->z - 1; z <= tile->z + 1; z++)
+        {
+            for (int x = tile->x - 1; x <= tile->x + 1; x++)
+            {
+                Tile* neighbour = GetMapTile(&battle->map, x, z);
+
+                if (neighbour == NULL || neighbour->entity == ENTITY_NONE || IsBattleTarget(battle, entity, neighbour->entity) == false)
+                {
+                    continue;
+                }
+
+                if (bestTarget == ENTITY_NONE || entities->healths[neighbour->entity] < entities->healths[bestTarget])
+                {
+                    bestTarget = neighbour->entity;
+                    bestTile = tile;
+                }
+            }
+        }
+    }
+
+    if (bestTarget != ENTITY_NONE)
+    {
+        action.type = ACTION_ATTACK_BASIC;
+        action.tileIndex = GetMapTileIndex(&battle->map, bestTile);
+        action.target = bestTarget;
+
+        return action;
+    }
+
+    // A reachable tile is at most speed tiles from the unit, so its closest target is within
+    // that many tiles of the target closest to the unit. Nothing further has to be looked at.
+    EntityGrid* entityGrid = &battle->entityGrid;
+    AiTargets targets = { battle, entity };
+    int closestTarget = ENTITY_NONE;
+
+    if (FindClosestGridEntities(entityGrid, entities->tileIndices[entity], 1, IsAiTarget, &targets, &closestTarget) == 0)
+    {
+        return action;
+    }
+
+    int range = GetTileDistance(start, GetEntityTile(battle, closestTarget)) + entities->infos[entity].speed;
+    int numTargets = QueryEntityGrid(entityGrid, entities->tileIndices[entity], range, IsAiTarget, &targets);
+    int bestDistance = INT_MAX;
+    int bestSteps = INT_MAX;
+
+    for (int i = 0; i < pathfinder->numReachableTiles; i++)
+    {
+        Tile* tile = pathfinder->reachableTiles[i];
+
+        // Units can walk past the dead but not stop on them.
+        if (tile != start && tile->entity != ENTITY_NONE)
+        {
+            continue;
+        }
+
+        for (int j = 0; j < numTargets; j++)
+        {
+            Tile* targetTile = GetEntityTile(battle, entityGrid->results[j]);
+            int distance = GetTileDistance(tile, targetTile);
+            int steps = abs(targetTile->x - tile->x) + abs(targetTile->z - tile->z);
+
+            // Straight steps break ties, otherwise a unit that can't get any closer diagonally
+            // in one turn, like on slow terrain, would never move at all.
+            if (distance < bestDistance || (distance == bestDistance && steps < bestSteps))
+            {
+                bestDistance = distance;
+                bestSteps = steps;
+                bestTile = tile;
+            }
+        }
+    }
+
+    if (bestTile != NULL && bestTile != start)
+    {
+        action.type = ACTION_MOVEMENT;
+        action.tileIndex = GetMapTileIndex(&battle->map, bestTile);
+    }
+
+    return action;
+}
+
+//----------------------------------------------------------------------------------
+// Search AI Functions Definition
+//----------------------------------------------------------------------------------
+static int GetAverageDamage(Entities* entities, int entity)
+{
+    return (entities->infos[entity].minAttack + entities->infos[entity].maxAttack) / 2;
+}
+
+static int GetTeamSign(AiSearch* search, int entity)
+{
+    return (search->battle->entities.teamIDs[entity] == search->team) ? 1 : -1;
+}
+
+// Keep the moves sorted by order, dropping the least promising one when full. Moves of the
+// same order stay in the order they were added.
+static void AddAiMove(AiMoveList* list, Action action, int order, int enemyDistance)
+{
+    AiMove* moves = list->moves;
+
+    if (list->numMoves == list->maxMoves && list->isComplete)
+    {
+        list->maxMoves = (list->maxMoves == 0) ? 64 : list->maxMoves * 2;
+        list->moves = (AiMove*)MemRealloc(list->moves, list->maxMoves * sizeof(AiMove));
+        moves = list->moves;
+    }
+
+    if (list->numMoves == list->maxMoves && moves[list->maxMoves - 1].order >= order)
+    {
+        return;
+    }
+
+    int index = (list->numMoves < list->maxMoves) ? list->numMoves++ : list->maxMoves - 1;
+
+    while (index > 0 && moves[index - 1].order < order)
+    {
+        moves[index] = moves[index - 1];
+        index--;
+    }
+
+    moves[index] = (AiMove){ action, order, enemyDistance };
+}
+
+// Distance from the tile to the closest of the enemies.
+static int GetEnemyDistance(Tile* tile, Tile** enemyTiles, int numEnemies)
+{
+    int distance = INT_MAX;
+
+    for (int i = 0; i < numEnemies; i++)
+    {
+        int enemyDistance = GetTileDistance(tile, enemyTiles[i]);
+
+        if (enemyDistance < distance) distance = enemyDistance;
+    }
+
+    return distance;
+}
+
+// Attacks on every target in reach, each from the cheapest tile to hit it from, then walks
+// towards the closest enemies. Waiting is searched too, walking into a hit isn't always better.
+// A complete list gets attacks from every tile instead of only the cheapest one.
+static void GenerateAiMoves(AiSearch* search, int entity, AiMoveList* list)
+{
+    Battle* battle = search->battle;
+    Entities* entities = &battle->entities;
+    Pathfinder* pathfinder = &battle->pathfinder;
+    Tile* start = GetEntityTile(battle, entity);
+    int damage = GetAverageDamage(entities, entity);
+
+    // Only the few closest enemies are walked towards, so a move costs the same in a battle
+    // of any size. Sorted by distance to the unit.
+    AiTargets targets = { battle, entity };
+    int enemies[AI_APPROACH_ENEMIES] = { 0 };
+    Tile* enemyTiles[AI_APPROACH_ENEMIES] = { 0 };
+    int numEnemies = FindClosestGridEntities(&battle->entityGrid, entities->tileIndices[entity], AI_APPROACH_ENEMIES, IsAiTarget, &targets, enemies);
+
+    for (int i = 0; i < numEnemies; i++)
+    {
+        enemyTiles[i] = GetEntityTile(battle, enemies[i]);
+    }
+
+    AddAiMove(list, (Action){ ACTION_WAIT, entity, -1, ENTITY_NONE }, INT_MIN + 1, (numEnemies > 0) ? GetTileDistance(start, enemyTiles[0]) : 0);
+
+    if (numEnemies == 0)
+    {
+        return;
+    }
+
+    FindReachableTiles(pathfinder, start, entities->infos[entity].speed);
+
+    for (int i = 0; i < pathfinder->numReachableTiles; i++)
+    {
+        Tile* tile = pathfinder->reachableTiles[i];
+
+        // Units can walk past the dead but not stop on them.
+        if (tile != start && tile->entity != ENTITY_NONE)
+        {
+            continue;
+        }
+
+        int tileIndex = GetMapTileIndex(&battle->map, tile);
+        int enemyDistance = GetEnemyDistance(tile, enemyTiles, numEnemies);
+
+        for (int z = tile->z - 1; z <= tile->z + 1; z++)
+        {
+            for (int x = tile->x - 1; x <= tile->x + 1; x++)
+            {
+                Tile* neighbour = GetMapTile(&battle->map, x, z);
+
+                if (neighbour == NULL || neighbour->entity == ENTITY_NONE || IsBattleTarget(battle, entity, neighbour->entity) == false)
+                {
+                    continue;
+                }
+
+                int target = neighbour->entity;
+                bool isKnown = false;
+
+                for (int j = 0; j < list->numMoves && list->isComplete == false; j++)
+                {
+                    if (list->moves[j].action.target == target) isKnown = true;
+                }
+
+                // Reachable tiles come in order of cost, the first one is the cheapest.
+                if (isKnown == false)
+                {
+                    int order = INT_MAX / 2 + ((damage >= entities->healths[target]) ? AI_UNIT_VALUE : 0) - entities->healths[target];
+
+                    AddAiMove(list, (Action){ ACTION_ATTACK_BASIC, entity, tileIndex, target }, order, enemyDistance);
+                }
+            }
+        }
+
+        if (tile != start)
+        {
+            AddAiMove(list, (Action){ ACTION_MOVEMENT, entity, tileIndex, ENTITY_NONE }, -enemyDistance, enemyDistance);
+        }
+    }
+}
+
+static bool IsAiTurnBefore(const AiTurn* a, const AiTurn* b)
+{
+    return (a->time < b->time) || (a->time == b->time && a->order < b->order);
+}
+
+// Index of the next living unit to act, -1 if nobody is left.
+static int GetNextAiTurn(AiSearch* search)
+{
+    Entities* entities = &search->battle->entities;
+    int next = -1;
+
+    for (int i = 0; i < search->numTurns; i++)
+    {
+        if ((entities->flags[search->turns[i].entity] & ENTITY_FLAG_ALIVE) == 0)
+        {
+            continue;
+        }
+
+        if (next == -1 || IsAiTurnBefore(&search->turns[i], &search->turns[next]))
+        {
+            next = i;
+        }
+    }
+
+    return next;
+}
+
+// Play the action of the unit at the given turn and give it its next turn.
+static AiUndo DoAiMove(AiSearch* search, int turn, const AiMove* move)
+{
+    Action action = move->action;
+    Battle* battle = search->battle;
+    Entities* entities = &battle->entities;
+    int entity = action.entity;
+    AiUndo undo = { entities->tileIndices[entity], 0, 0, turn, search->turns[turn] };
+
+    if (action.type != ACTION_WAIT)
+    {
+        SetTileEntity(&battle->map, GetEntityTile(battle, entity), ENTITY_NONE);
+        entities->tileIndices[entity] = action.tileIndex;
+        SetTileEntity(&battle->map, GetMapTileByIndex(&battle->map, action.tileIndex), entity);
+        UpdateGridEntity(&battle->entityGrid, entity);
+    }
+
+    if (action.type == ACTION_ATTACK_BASIC)
+    {
+        int target = action.target;
+        int health = entities->healths[target] - GetAverageDamage(entities, entity);
+
+        undo.targetHealth = entities->healths[target];
+        undo.targetFlags = entities->flags[target];
+
+        if (health <= 0)
+        {
+            health = 0;
+            entities->flags[target] &= ~(ENTITY_FLAG_ALIVE | ENTITY_FLAG_BLOCKING);
+            search->numUnits[entities->teamIDs[target]]--;
+            search->score -= GetTeamSign(search, target) * AI_UNIT_VALUE;
+        }
+
+        search->score -= GetTeamSign(search, target) * (entities->healths[target] - health);
+        entities->healths[target] = health;
+    }
+
+    search->score -= GetTeamSign(search, entity) * move->enemyDistance * AI_DISTANCE_VALUE;
+    search->turns[turn].time += entities->initiatives[entity];
+    search->turns[turn].order = search->nextOrder;
+    search->nextOrder++;
+
+    return undo;
+}
+
+static void UndoAiMove(AiSearch* search, const AiMove* move, AiUndo undo)
+{
+    Action action = move->action;
+    Battle* battle = search->battle;
+    Entities* entities = &battle->entities;
+    int entity = action.entity;
+
+    search->score += GetTeamSign(search, entity) * move->enemyDistance * AI_DISTANCE_VALUE;
+    search->turns[undo.turn] = undo.turnBefore;
+    search->nextOrder--;
+
+    if (action.type == ACTION_ATTACK_BASIC)
+    {
+        int target = action.target;
+
+        if ((entities->flags[target] & ENTITY_FLAG_ALIVE) == 0 && (undo.targetFlags & ENTITY_FLAG_ALIVE))
+        {
+            search->numUnits[entities->teamIDs[target]]++;
+            search->score += GetTeamSign(search, target) * AI_UNIT_VALUE;
+        }
+
+        search->score += GetTeamSign(search, target) * (undo.targetHealth - entities->healths[target]);
+        entities->healths[target] = undo.targetHealth;
+        entities->flags[target] = undo.targetFlags;
+    }
+
+    if (action.type != ACTION_WAIT)
+    {
+        SetTileEntity(&battle->map, GetEntityTile(battle, entity), ENTITY_NONE);
+        entities->tileIndices[entity] = undo.fromTile;
+        SetTileEntity(&battle->map, GetMapTileByIndex(&battle->map, undo.fromTile), entity);
+        UpdateGridEntity(&battle->entityGrid, entity);
+    }
+}
+
+// Score of the battle for the searching team, or 0 once it runs out of time or nodes.
+static int SearchAiMoves(AiSearch* search, int ply, int depth, int alpha, int beta)
+{
+    int numTeamsLeft = 0;
+
+    for (int i = 0; i < BATTLE_TEAMS; i++)
+    {
+        if (search->numUnits[i] > 0) numTeamsLeft++;
+    }
+
+    // Quicker wins and slower losses score better.
+    if (numTeamsLeft <= 1)
+    {
+        return (search->numUnits[search->team] > 0) ? AI_WIN_SCORE - ply : -AI_WIN_SCORE + ply;
+    }
+
+    if (depth == 0)
+    {
+        return search->score;
+    }
+
+    search->numNodes++;
+
+    if (search->maxNodes > 0 && search->numNodes >= search->maxNodes) search->isAborted = true;
+    if (search->endTime > 0.0 && (search->numNodes % AI_CLOCK_NODES) == 0 && GetMonotonicTime() >= search->endTime) search->isAborted = true;
+
+    if (search->isAborted)
+    {
+        return 0;
+    }
+
+    int turn = GetNextAiTurn(search);
+    int entity = search->turns[turn].entity;
+    bool isMaximizing = (search->battle->entities.teamIDs[entity] == search->team);
+    AiMoveList list = { search->moves[ply], 0, AI_MAX_MOVES, false };
+    AiMove* moves = list.moves;
+    int best = isMaximizing ? INT_MIN : INT_MAX;
+
+    GenerateAiMoves(search, entity, &list);
+
+    for (int i = 0; i < list.numMoves; i++)
+    {
+        AiUndo undo = DoAiMove(search, turn, &moves[i]);
+        int score = SearchAiMoves(search, ply + 1, depth - 1, alpha, beta);
+        UndoAiMove(search, &moves[i], undo);
+
+        if (search->isAborted)
+        {
+            return 0;
+        }
+
+        if (isMaximizing)
+        {
+            if (score > best) best = score;
+            if (best > alpha) alpha = best;
+        }
+        else
+        {
+            if (score < best) best = score;
+            if (best < beta) beta = best;
+        }
+
+        if (alpha >= beta)
+        {
+            break;
+        }
+    }
+
+    return best;
+}
+
+// Set up a search for the active unit of the battle.
+static void BeginAiSearch(AiSearch* search, Battle* battle, AiSearchLimits limits, double endTime)
+{
+    Entities* entities = &battle->entities;
+    TurnScheduler* scheduler = &battle->turnScheduler;
+    int entity = battle->activeEntity;
+
+    search->battle = battle;
+    search->team = entities->teamIDs[entity];
+    search->turns = (AiTurn*)MemRealloc(search->turns, (scheduler->numEntries + 1) * sizeof(AiTurn));
+    search->numTurns = 0;
+    search->nextOrder = scheduler->nextOrder;
+    search->score = 0;
+    search->numNodes = 0;
+    search->maxNodes = limits.maxNodes;
+    search->endTime = endTime;
+    search->isAborted = false;
+
+    for (int i = 0; i < BATTLE_TEAMS; i++)
+    {
+        search->numUnits[i] = 0;
+    }
+
+    // The active unit is out of the scheduler during its turn, it acts before anyone else.
+    search->turns[search->numTurns++] = (AiTurn){ entity, scheduler->time, 0 };
+
+    for (int i = 0; i < scheduler->numEntries; i++)
+    {
+        TurnEntry* entry = &scheduler->entries[i];
+
+        if (entities->flags[entry->entity] & ENTITY_FLAG_ALIVE)
+        {
+            search->turns[search->numTurns++] = (AiTurn){ entry->entity, entry->time, entry->order };
+        }
+    }
+
+    for (int i = 0; i < search->numTurns; i++)
+    {
+        int unit = search->turns[i].entity;
+
+        search->numUnits[entities->teamIDs[unit]]++;
+        search->score += GetTeamSign(search, unit) * (entities->healths[unit] + AI_UNIT_VALUE);
+    }
+}
+
+static double GetAiEndTime(AiSearchLimits limits)
+{
+    return (limits.timeBudget > 0.0) ? GetMonotonicTime() + limits.timeBudget : 0.0;
+}
+
+static int GetAiMaxDepth(AiSearchLimits limits)
+{
+    return (limits.maxDepth > 0 && limits.maxDepth < AI_MAX_DEPTH) ? limits.maxDepth : AI_MAX_DEPTH;
+}
+
+static bool IsAiScoreFinal(int score)
+{
+    return (score >= AI_WIN_SCORE - AI_MAX_DEPTH || score <= -AI_WIN_SCORE + AI_MAX_DEPTH);
+}
+
+// Move the best action first, the next depth searches it first.
+static void SortAiBestMove(AiMove* moves, int bestMove)
+{
+    AiMove move = moves[bestMove];
+
+    for (int i = bestMove; i > 0; i--) moves[i] = moves[i - 1];
+    moves[0] = move;
+}
+
+// Search deeper and deeper until a limit is hit, the action of the deepest finished search
+// wins. The best action so far is searched first, which makes the cutoffs of the next
+// depth much more likely.
+Action ChooseSearchAction(Battle* battle, AiSearchLimits limits)
+{
+    int entity = battle->activeEntity;
+    Action best = { ACTION_WAIT, entity, -1, ENTITY_NONE };
+
+    if (entity == ENTITY_NONE || battle->isFinished)
+    {
+        return best;
+    }
+
+    AiSearch* search = (AiSearch*)MemAlloc(sizeof(AiSearch));
+    BeginAiSearch(search, battle, limits, GetAiEndTime(limits));
+
+    AiMove rootMoves[AI_MAX_MOVES] = { 0 };
+    AiMoveList list = { rootMoves, 0, AI_MAX_MOVES, false };
+
+    GenerateAiMoves(search, entity, &list);
+
+    for (int depth = 1; depth <= GetAiMaxDepth(limits); depth++)
+    {
+        int alpha = INT_MIN;
+        int bestMove = -1;
+
+        for (int i = 0; i < list.numMoves; i++)
+        {
+            AiUndo undo = DoAiMove(search, 0, &rootMoves[i]);
+            int score = SearchAiMoves(search, 1, depth - 1, alpha, INT_MAX);
+            UndoAiMove(search, &rootMoves[i], undo);
+
+            // Only a finished search can be trusted, a one turn search always finishes.
+            if (search->isAborted && depth > 1)
+            {
+                break;
+            }
+
+            if (bestMove == -1 || score > alpha)
+            {
+                alpha = score;
+                bestMove = i;
+            }
+        }
+
+        if (search->isAborted && depth > 1)
+        {
+            break;
+        }
+
+        SortAiBestMove(rootMoves, bestMove);
+        best = rootMoves[0].action;
+
+        if (search->isAborted || IsAiScoreFinal(alpha))
+        {
+            break;
+        }
+    }
+
+    MemFree(search->turns);
+    MemFree(search);
+
+    return best;
+}
+
+//----------------------------------------------------------------------------------
+// Parallel Search AI Functions Definition
+//----------------------------------------------------------------------------------
+// Searches one action at a time on a battle of its own.
+typedef struct AiWorker
+{
+    Battle battle;
+    AiSearch search;
+    bool isLoaded;
+    bool isSynced;                  // Battle matches the snapshot of the current search.
+
+} AiWorker;
+
+struct AiWorkers
+{
+    ThreadPool* pool;
+    AiWorker* workers;
+    int numWorkers;
+
+    BattleSnapshot snapshot;        // Battle being searched.
+    unsigned int seed;              // Map of the battle being searched.
+    int width;
+    int height;
+    int maxLoadedChunks;
+
+    AiSearchLimits limits;
+    double endTime;
+    AiMoveList rootMoves;
+    int* scores;
+    bool* isAborted;
+    int depth;
+};
+
+// Workers copy the battle when they get their first action of a search, a worker without
+// actions to search never copies anything.
+static void SyncAiWorker(AiWorkers* workers, AiWorker* worker)
+{
+    Battle* battle = &worker->battle;
+
+    if (worker->isLoaded == false || battle->map.seed != workers->seed || battle->map.width != workers->width || battle->map.height != workers->height)
+    {
+        if (worker->isLoaded) UnloadBattle(battle);
+
+        worker->isLoaded = LoadBattle(battle, workers->width, workers->height, workers->maxLoadedChunks, workers->seed);
+    }
+
+    LoadBattleSnapshot(battle, &workers->snapshot);
+    BeginAiSearch(&worker->search, battle, workers->limits, workers->endTime);
+
+    Tile* tile = GetEntityTile(battle, battle->activeEntity);
+    EvictMapChunks(&battle->map, tile->x, tile->z);
+
+    worker->isSynced = true;
+}
+
+static void RunAiTask(void* data, int taskIndex, int workerIndex)
+{
+    AiWorkers* workers = (AiWorkers*)data;
+    AiWorker* worker = &workers->workers[workerIndex];
+    AiSearch* search = &worker->search;
+    AiMove* move = &workers->rootMoves.moves[taskIndex];
+
+    if (worker->isSynced == false)
+    {
+        SyncAiWorker(workers, worker);
+    }
+
+    // Every action gets the whole node limit and a full window, so its score doesn't depend
+    // on which worker searched it or what was searched before.
+    search->numNodes = 0;
+    search->isAborted = false;
+
+    AiUndo undo = DoAiMove(search, 0, move);
+    workers->scores[taskIndex] = SearchAiMoves(search, 1, workers->depth - 1, INT_MIN, INT_MAX);
+    UndoAiMove(search, move, undo);
+
+    workers->isAborted[taskIndex] = search->isAborted;
+}
+
+// Workers for ChooseParallelSearchAction(), one per thread of the pool.
+AiWorkers* LoadAiWorkers(ThreadPool* pool)
+{
+    AiWorkers* workers = (AiWorkers*)MemAlloc(sizeof(AiWorkers));
+
+    workers->pool = pool;
+    workers->numWorkers = GetThreadPoolWorkers(pool);
+    workers->workers = (AiWorker*)MemAlloc(workers->numWorkers * sizeof(AiWorker));
+    workers->rootMoves.isComplete = true;
+
+    return workers;
+}
+
+void UnloadAiWorkers(AiWorkers* workers)
+{
+    if (workers == NULL)
+    {
+        return;
+    }
+
+    for (int i = 0; i < workers->numWorkers; i++)
+    {
+        if (workers->workers[i].isLoaded) UnloadBattle(&workers->workers[i].battle);
+        MemFree(workers->workers[i].search.turns);
+    }
+
+    UnloadBattleSnapshot(&workers->snapshot);
+    MemFree(workers->rootMoves.moves);
+    MemFree(workers->scores);
+    MemFree(workers->isAborted);
+    MemFree(workers->workers);
+    MemFree(workers);
+}
+
+// Like ChooseSearchAction(), but every action the unit can take is searched, each on its
+// own and spread over the workers. Picks the same action with any number of workers as long
+// as there is no time budget. The node limit is per action here.
+Action ChooseParallelSearchAction(AiWorkers* workers, Battle* battle, AiSearchLimits limits)
+{
+    int entity = battle->activeEntity;
+    Action best = { ACTION_WAIT, entity, -1, ENTITY_NONE };
+
+    if (entity == ENTITY_NONE || battle->isFinished)
+    {
+        return best;
+    }
+
+    workers->limits = limits;
+    workers->endTime = GetAiEndTime(limits);
+    workers->seed = battle->map.seed;
+    workers->width = battle->map.width;
+    workers->height = battle->map.height;
+    workers->maxLoadedChunks = battle->map.maxLoadedChunks;
+
+    SaveBattleSnapshot(battle, &workers->snapshot);
+
+    for (int i = 0; i < workers->numWorkers; i++)
+    {
+        workers->workers[i].isSynced = false;
+    }
+
+    // The actions come from the battle itself, the workers only search them.
+    AiSearch* search = &workers->workers[0].search;
+    AiMoveList* list = &workers->rootMoves;
+
+    BeginAiSearch(search, battle, limits, workers->endTime);
+    list->numMoves = 0;
+    GenerateAiMoves(search, entity, list);
+
+    workers->scores = (int*)MemRealloc(workers->scores, list->maxMoves * sizeof(int));
+    workers->isAborted = (bool*)MemRealloc(workers->isAborted, list->maxMoves * sizeof(bool));
+
+    for (int depth = 1; depth <= GetAiMaxDepth(limits); depth++)
+    {
+        workers->depth = depth;
+
+        RunParallelFor(workers->pool, list->numMoves, RunAiTask, workers);
+
+        // Reduced in the order of the actions, the first one of the best score wins.
+        int bestMove = 0;
+        bool isAborted = false;
+
+        for (int i = 0; i < list->numMoves; i++)
+        {
+            if (workers->isAborted[i]) isAborted = true;
+            if (workers->scores[i] > workers->scores[bestMove]) bestMove = i;
+        }
+
+        if (isAborted && depth > 1)
+        {
+            break;
+        }
+
+        int score = workers->scores[bestMove];
+
+        SortAiBestMove(list->moves, bestMove);
+        best = list->moves[0].action;
+
+        if (isAborted || IsAiScoreFinal(score))
+        {
+            break;
+        }
+    }
+
+    return best;
+}
@@ -0,0 +1,33 @@
+#ifndef AI_H
+#define AI_H
+
+#include "battle.h"
+#include "thread_pool.h"
+
+#define AI_MAX_DEPTH 8				// Turns searched ahead at most.
+#define AI_MAX_MOVES 12				// Actions searched per turn, the most promising ones.
+#define AI_TIME_BUDGET 0.005		// Seconds per turn for units played by the game.
+
+// Where ChooseSearchAction() stops deepening, at whichever limit comes first. Zero means
+// no limit, at least a one turn search is always completed. Without a time budget the
+// search gives the same action for the same battle on any machine.
+typedef struct AiSearchLimits
+{
+	int maxDepth;
+	int maxNodes;
+	double timeBudget;			// Seconds.
+
+} AiSearchLimits;
+
+// Battle copies of the pool's threads for the parallel search, kept from one search to
+// the next.
+typedef struct AiWorkers AiWorkers;
+
+Action ChooseGreedyAction(Battle* battle);
+Action ChooseSearchAction(Battle* battle, AiSearchLimits limits);
+
+AiWorkers* LoadAiWorkers(ThreadPool* pool);
+void UnloadAiWorkers(AiWorkers* workers);
+Action ChooseParallelSearchAction(AiWorkers* workers, Battle* battle, AiSearchLimits limits);
+
+#endif
@@ -0,0 +1,663 @@
+/**********************************************************************************************
+*
+*   Assets - Asset registry and asynchronous loading
+*
+*   Assets are registered by type and file name in a hash table, a handle is the index of the
+*   asset plus one. Registered assets are never removed, only their data is loaded and
+*   unloaded, so a handle never goes stale.
+*
+*   A loader thread takes the queued assets in batches and decodes them in parallel on a
+*   thread pool, the loader thread being one of its workers. Decoding is the slow part: PNG,
+*   OGG and WAV files are read and unpacked without touching the GPU or the audio device.
+*   Uploads need the main thread, UpdateAssetManager() does them every frame for whatever
+*   was decoded since.
+*
+*   The loader owns the decoded members of an asset from QUEUED until DECODED, everything
+*   else belongs to the main thread. A reload decodes next to the loaded data and replaces it
+*   on upload, the asset stays usable meanwhile.
+*
+**********************************************************************************************/
+
+#include "assets.h"
+#include "atlas.h"
+#include "thread_pool.h"
+#include "threads.h"
+
+#include <string.h>
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+#define MAX_ASSET_PATH 256
+#define ASSET_TABLE_SIZE (MAX_ASSETS * 2)  // Power of two, the table is never more than half full.
+
+#define ATLAS_PAGE_SIZE 1024
+#define DEFAULT_MEMORY_BUDGET (256 * 1024 * 1024)
+#define HOT_RELOAD_INTERVAL 1.0            // Seconds between checks for changed files.
+
+#define FONT_FIRST_CHAR 32      // Same glyphs LoadFont() would give.
+#define FONT_SIZE 32
+#define FONT_GLYPHS 95
+
+enum AssetState
+{
+    ASSET_IDLE,
+    ASSET_QUEUED,
+    ASSET_DECODING,
+    ASSET_DECODED
+};
+
+typedef struct Asset
+{
+    int type;
+    char fileName[MAX_ASSET_PATH];
+
+    int numReferences;
+    bool isLoaded;                  // The members below hold the asset, empty ones if the file failed to load.
+    unsigned int lastUsedFrame;
+    long modTime;                   // Modification time of the file when it was last queued.
+    int memorySize;
+
+    Texture2D texture;
+    Image image;
+    AtlasRegion region;             // Page -1 until the sprite is packed.
+    Font font;
+    Sound sound;
+    Music music;
+    unsigned char* musicData;       // Music is streamed from the file data.
+
+    // Filled by the loader, freed on upload.
+    Image decodedImage;
+    Wave decodedWave;
+    unsigned char* decodedData;
+    int decodedSize;
+} Asset;
+
+struct AssetManager
+{
+    Asset assets[MAX_ASSETS];
+    volatile long states[MAX_ASSETS];       // AssetState of each asset. Only accessed atomically.
+    int numAssets;
+    AssetHandle table[ASSET_TABLE_SIZE];    // Handles by hash of type and file name, linear probing.
+
+    SpriteAtlas atlas;
+    ThreadPool* pool;
+    Thread thread;
+
+    Mutex lock;                     // Guards the members below.
+    Condition workReady;
+    int numQueued;
+    bool isQuitting;
+
+    int batch[MAX_ASSETS];          // Assets being decoded, only touched by the loader thread.
+    int numBatch;
+
+    unsigned int frame;             // Main thread only from here on.
+    int numPending;                 // Assets queued but not yet uploaded,
+    int numRequested;               // assets queued since loading last started,
+    double loadStartTime;           // and when that was.
+
+    int memoryUsage;
+    int memoryBudget;
+    bool isHotReloadEnabled;
+    double lastHotReloadTime;
+};
+
+//----------------------------------------------------------------------------------
+// Loader Functions Definition
+//----------------------------------------------------------------------------------
+static bool IsFontImage(const char* fileName)
+{
+    return IsFileExtension(fileName, ".png");
+}
+
+static bool IsFontFile(const char* fileName)
+{
+    return IsFileExtension(fileName, ".ttf;.otf");
+}
+
+// Everything that can be done without the GPU or the audio device.
+static void DecodeAssetTask(void* data, int taskIndex, int workerIndex)
+{
+    (void)workerIndex;
+
+    AssetManager* manager = (AssetManager*)data;
+    int index = manager->batch[taskIndex];
+    Asset* asset = &manager->assets[index];
+
+    switch (asset->type)
+    {
+        case ASSET_TEXTURE: asset->decodedImage = LoadImage(asset->fileName); break;
+        case ASSET_IMAGE:
+        case ASSET_SPRITE:
+        {
+            asset->decodedImage = LoadImage(asset->fileName);
+            if (asset->decodedImage.data != NULL) ImageFormat(&asset->decodedImage, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+
+        } break;
+        case ASSET_FONT:
+        {
+            if (IsFontImage(asset->fileName)) asset->decodedImage = LoadImage(asset->fileName);
+            else if (IsFontFile(asset->fileName)) asset->decodedData = LoadFileData(asset->fileName, &asset->decodedSize);
+
+        } break;
+        case ASSET_SOUND: asset->decodedWave = LoadWave(asset->fileName); break;
+        case ASSET_MUSIC: asset->decodedData = LoadFileData(asset->fileName, &asset->decodedSize); break;
+        default: break;
+    }
+
+    StoreAtomic(&manager->states[index], ASSET_DECODED);
+}
+
+static void RunLoaderThread(void* data)
+{
+    AssetManager* manager = (AssetManager*)data;
+
+    for (;;)
+    {
+        LockMutex(&manager->lock);
+
+        while (manager->isQuitting == false && manager->numQueued == 0)
+        {
+            WaitCondition(&manager->workReady, &manager->lock);
+        }
+
+        if (manager->isQuitting)
+        {
+            UnlockMutex(&manager->lock);
+            break;
+        }
+
+        manager->numBatch = 0;
+
+        for (int i = 0; i < MAX_ASSETS; i++)
+        {
+            if (LoadAtomic(&manager->states[i]) == ASSET_QUEUED)
+            {
+                StoreAtomic(&manager->states[i], ASSET_DECODING);
+                manager->batch[manager->numBatch++] = i;
+            }
+        }
+
+        manager->numQueued = 0;
+
+        UnlockMutex(&manager->lock);
+
+        RunParallelFor(manager->pool, manager->numBatch, DecodeAssetTask, manager);
+    }
+}
+
+//----------------------------------------------------------------------------------
+// Asset Functions Definition
+//----------------------------------------------------------------------------------
+static unsigned int HashAssetName(int type, const char* fileName)
+{
+    unsigned int hash = 2166136261u ^ (unsigned int)type;
+
+    for (const char* c = fileName; *c != '\0'; c++)
+    {
+        hash = (hash ^ (unsigned char)*c) * 16777619u;
+    }
+
+    return hash;
+}
+
+static void QueueAsset(AssetManager* manager, int index)
+{
+    Asset* asset = &manager->assets[index];
+
+    asset->modTime = GetFileModTime(asset->fileName);
+
+    if (manager->numPending == 0)
+    {
+        manager->loadStartTime = GetTime();
+    }
+
+    manager->numPending++;
+    manager->numRequested++;
+
+    LockMutex(&manager->lock);
+    StoreAtomic(&manager->states[index], ASSET_QUEUED);
+    manager->numQueued++;
+    SignalCondition(&manager->workReady);
+    UnlockMutex(&manager->lock);
+}
+
+// Asset behind the handle, queued for loading if it isn't loaded. NULL for invalid handles.
+static Asset* UseAsset(AssetManager* manager, AssetHandle handle)
+{
+    if (handle == ASSET_NONE || handle > (AssetHandle)manager->numAssets)
+    {
+        return NULL;
+    }
+
+    int index = (int)handle - 1;
+    Asset* asset = &manager->assets[index];
+
+    asset->lastUsedFrame = manager->frame;
+
+    if (asset->isLoaded == false && LoadAtomic(&manager->states[index]) == ASSET_IDLE)
+    {
+        QueueAsset(manager, index);
+    }
+
+    return asset;
+}
+
+static void FreeDecodedAsset(Asset* asset)
+{
+    if (asset->decodedImage.data != NULL) UnloadImage(asset->decodedImage);
+    if (asset->decodedWave.data != NULL) UnloadWave(asset->decodedWave);
+    if (asset->decodedData != NULL) UnloadFileData(asset->decodedData);
+
+    asset->decodedImage = (Image){ 0 };
+    asset->decodedWave = (Wave){ 0 };
+    asset->decodedData = NULL;
+    asset->decodedSize = 0;
+}
+
+// Free the loaded data, the asset stays registered and loads again on next use. Sprites
+// can't give their atlas space back, they stay loaded.
+static void ReleaseAsset(AssetManager* manager, Asset* asset)
+{
+    switch (asset->type)
+    {
+        case ASSET_TEXTURE: if (asset->texture.id != 0) UnloadTexture(asset->texture); break;
+        case ASSET_IMAGE: if (asset->image.data != NULL) UnloadImage(asset->image); break;
+        case ASSET_SPRITE: return;
+        case ASSET_FONT: if (asset->font.texture.id != 0) UnloadFont(asset->font); break;
+        case ASSET_SOUND: if (asset->sound.frameCount != 0) UnloadSound(asset->sound); break;
+        case ASSET_MUSIC:
+        {
+            if (asset->musicData != NULL)
+            {
+                UnloadMusicStream(asset->music);
+                UnloadFileData(asset->musicData);
+            }
+
+        } break;
+        default: break;
+    }
+
+    asset->texture = (Texture2D){ 0 };
+    asset->image = (Image){ 0 };
+    asset->font = (Font){ 0 };
+    asset->sound = (Sound){ 0 };
+    asset->music = (Music){ 0 };
+    asset->musicData = NULL;
+
+    manager->memoryUsage -= asset->memorySize;
+    asset->memorySize = 0;
+    asset->isLoaded = false;
+}
+
+static bool IsAssetDecoded(Asset* asset)
+{
+    if (asset->type == ASSET_FONT && IsFontImage(asset->fileName) == false && IsFontFile(asset->fileName) == false)
+    {
+        return true;    // Other formats, like BMFont, refer to more files. Those are left for raylib.
+    }
+
+    return (asset->decodedImage.data != NULL || asset->decodedWave.data != NULL || asset->decodedData != NULL);
+}
+
+static void UploadSprite(AssetManager* manager, Asset* asset)
+{
+    Image image = asset->decodedImage;
+    Rectangle rect = asset->region.rect;
+
+    // A reload of the same size goes over the old pixels, otherwise the old space is lost.
+    if (asset->region.page >= 0 && rect.width == image.width && rect.height == image.height)
+    {
+        UpdateAtlasSprite(&manager->atlas, asset->region, image);
+        return;
+    }
+
+    int numPages = manager->atlas.numPages;
+    AtlasRegion region = { 0 };
+
+    if (AddAtlasSprite(&manager->atlas, image, &region)) asset->region = region;
+
+    manager->memoryUsage += (manager->atlas.numPages - numPages) * GetPixelDataSize(ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+}
+
+// The upload half of loading, on the main thread. A failed reload keeps what was loaded.
+static void UploadAsset(AssetManager* manager, int index)
+{
+    Asset* asset = &manager->assets[index];
+
+    if (IsAssetDecoded(asset) == false)
+    {
+        asset->isLoaded = true;
+        StoreAtomic(&manager->states[index], ASSET_IDLE);
+        return;
+    }
+
+    if (asset->isLoaded) ReleaseAsset(manager, asset);
+
+    switch (asset->type)
+    {
+        case ASSET_TEXTURE:
+        {
+            asset->texture = LoadTextureFromImage(asset->decodedImage);
+            asset->memorySize = GetPixelDataSize(asset->texture.width, asset->texture.height, asset->texture.format);
+
+        } break;
+        case ASSET_IMAGE:
+        {
+            asset->image = asset->decodedImage;
+            asset->decodedImage = (Image){ 0 };
+            asset->memorySize = GetPixelDataSize(asset->image.width, asset->image.height, asset->image.format);
+
+        } break;
+        case ASSET_SPRITE: UploadSprite(manager, asset); break;
+        case ASSET_FONT:
+        {
+            if (asset->decodedImage.data != NULL) asset->font = LoadFontFromImage(asset->decodedImage, MAGENTA, FONT_FIRST_CHAR);
+            else if (asset->decodedData != NULL) asset->font = LoadFontFromMemory(GetFileExtension(asset->fileName), asset->decodedData, asset->decodedSize, FONT_SIZE, NULL, FONT_GLYPHS);
+            else asset->font = LoadFont(asset->fileName);
+
+            asset->memorySize = GetPixelDataSize(asset->font.texture.width, asset->font.texture.height, asset->font.texture.format);
+
+        } break;
+        case ASSET_SOUND:
+        {
+            asset->sound = LoadSoundFromWave(asset->decodedWave);
+            asset->memorySize = (int)(asset->decodedWave.frameCount * asset->decodedWave.channels * asset->decodedWave.sampleSize / 8);
+
+        } break;
+        case ASSET_MUSIC:
+        {
+            asset->music = LoadMusicStreamFromMemory(GetFileExtension(asset->fileName), asset->decodedData, asset->decodedSize);
+            asset->musicData = asset->decodedData;
+            asset->memorySize = asset->decodedSize;
+            asset->decodedData = NULL;
+
+        } break;
+        default: break;
+    }
+
+    FreeDecodedAsset(asset);
+
+    manager->memoryUsage += asset->memorySize;
+    asset->isLoaded = true;
+
+    StoreAtomic(&manager->states[index], ASSET_IDLE);
+}
+
+static void FinishPendingAsset(AssetManager* manager)
+{
+    manager->numPending--;
+
+    if (manager->numPending == 0)
+    {
+        TraceLog(LOG_INFO, "ASSETS: Loaded %d asset(s) in %.3f s", manager->numRequested, GetTime() - manager->loadStartTime);
+        manager->numRequested = 0;
+    }
+}
+
+// Release unreferenced assets, least recently used first, until the budget is met. Assets
+// used during the last frame are likely to be drawn again and stay.
+static void EvictAssets(AssetManager* manager)
+{
+    while (manager->memoryUsage > manager->memoryBudget)
+    {
+        Asset* oldest = NULL;
+
+        for (int i = 0; i < manager->numAssets; i++)
+        {
+            Asset* asset = &manager->assets[i];
+
+            if (asset->isLoaded == false || asset->numReferences > 0 || asset->memorySize == 0 ||
+                asset->lastUsedFrame + 1 >= manager->frame || LoadAtomic(&manager->states[i]) != ASSET_IDLE)
+            {
+                continue;
+            }
+
+            if (oldest == NULL || asset->lastUsedFrame < oldest->lastUsedFrame) oldest = asset;
+        }
+
+        if (oldest == NULL)
+        {
+            break;
+        }
+
+        TraceLog(LOG_DEBUG, "ASSETS: [%s] Unloaded to stay in the memory budget", oldest->fileName);
+        ReleaseAsset(manager, oldest);
+    }
+}
+
+// Load again the assets whose files changed, they keep their handles.
+static void ReloadChangedAssets(AssetManager* manager)
+{
+    for (int i = 0; i < manager->numAssets; i++)
+    {
+        Asset* asset = &manager->assets[i];
+
+        if (asset->isLoaded && LoadAtomic(&manager->states[i]) == ASSET_IDLE && GetFileModTime(asset->fileName) != asset->modTime)
+        {
+            TraceLog(LOG_INFO, "ASSETS: [%s] File changed, reloading", asset->fileName);
+            QueueAsset(manager, i);
+        }
+    }
+}
+
+// Start the loader, numWorkers <= 0 decodes on every core.
+AssetManager* LoadAssetManager(int numWorkers)
+{
+    AssetManager* manager = (AssetManager*)MemAlloc(sizeof(AssetManager));
+
+    manager->pool = LoadThreadPool(numWorkers);
+    manager->memoryBudget = DEFAULT_MEMORY_BUDGET;
+
+    LoadSpriteAtlas(&manager->atlas, ATLAS_PAGE_SIZE);
+
+    InitMutex(&manager->lock);
+    InitCondition(&manager->workReady);
+
+    StartThread(&manager->thread, RunLoaderThread, manager);
+
+    TraceLog(LOG_INFO, "ASSETS: Decoding on %d thread(s)", GetThreadPoolWorkers(manager->pool));
+
+    return manager;
+}
+
+// Waits for the batch being decoded and frees every asset, referenced or not.
+void UnloadAssetManager(AssetManager* manager)
+{
+    if (manager == NULL)
+    {
+        return;
+    }
+
+    LockMutex(&manager->lock);
+    manager->isQuitting = true;
+    SignalCondition(&manager->workReady);
+    UnlockMutex(&manager->lock);
+
+    JoinThread(&manager->thread);
+
+    UnloadThreadPool(manager->pool);
+
+    for (int i = 0; i < manager->numAssets; i++)
+    {
+        if (manager->assets[i].isLoaded) ReleaseAsset(manager, &manager->assets[i]);
+        FreeDecodedAsset(&manager->assets[i]);
+    }
+
+    UnloadSpriteAtlas(&manager->atlas);
+
+    DestroyCondition(&manager->workReady);
+    DestroyMutex(&manager->lock);
+
+    MemFree(manager);
+}
+
+// Call once per frame: uploads what was decoded since the last call, checks for changed files
+// and unloads assets over the memory budget.
+void UpdateAssetManager(AssetManager* manager)
+{
+    manager->frame++;
+
+    for (int i = 0; i < manager->numAssets && manager->numPending > 0; i++)
+    {
+        if (LoadAtomic(&manager->states[i]) == ASSET_DECODED)
+        {
+            UploadAsset(manager, i);
+            FinishPendingAsset(manager);
+        }
+    }
+
+    if (manager->isHotReloadEnabled && GetTime() - manager->lastHotReloadTime >= HOT_RELOAD_INTERVAL)
+    {
+        ReloadChangedAssets(manager);
+        manager->lastHotReloadTime = GetTime();
+    }
+
+    if (manager->memoryUsage > manager->memoryBudget)
+    {
+        EvictAssets(manager);
+    }
+}
+
+// Handle of the file, registered on first call. Nothing is loaded before the asset is used.
+// Returns ASSET_NONE if the registry is full.
+AssetHandle GetAssetHandle(AssetManager* manager, int type, const char* fileName)
+{
+    unsigned int slot = HashAssetName(type, fileName) & (ASSET_TABLE_SIZE - 1);
+
+    while (manager->table[slot] != ASSET_NONE)
+    {
+        Asset* asset = &manager->assets[manager->table[slot] - 1];
+
+        if (asset->type == type && strcmp(asset->fileName, fileName) == 0)
+        {
+            return manager->table[slot];
+        }
+
+        slot = (slot + 1) & (ASSET_TABLE_SIZE - 1);
+    }
+
+    if (manager->numAssets == MAX_ASSETS || strlen(fileName) >= MAX_ASSET_PATH)
+    {
+        TraceLog(LOG_WARNING, "ASSETS: [%s] Asset could not be registered", fileName);
+        return ASSET_NONE;
+    }
+
+    Asset* asset = &manager->assets[manager->numAssets++];
+
+    asset->type = type;
+    strcpy(asset->fileName, fileName);
+    asset->region.page = -1;
+
+    manager->table[slot] = (AssetHandle)manager->numAssets;
+
+    return manager->table[slot];
+}
+
+// Start loading the file now and keep it loaded until the reference is unloaded.
+AssetHandle LoadAsset(AssetManager* manager, int type, const char* fileName)
+{
+    AssetHandle handle = GetAssetHandle(manager, type, fileName);
+    Asset* asset = UseAsset(manager, handle);
+
+    if (asset != NULL) asset->numReferences++;
+
+    return handle;
+}
+
+// Drop a reference. The asset stays loaded until the memory budget needs the space.
+void UnloadAsset(AssetManager* manager, AssetHandle handle)
+{
+    if (handle == ASSET_NONE || handle > (AssetHandle)manager->numAssets)
+    {
+        return;
+    }
+
+    Asset* asset = &manager->assets[handle - 1];
+
+    if (asset->numReferences > 0) asset->numReferences--;
+}
+
+bool IsAssetReady(AssetManager* manager, AssetHandle handle)
+{
+    return (handle != ASSET_NONE && handle <= (AssetHandle)manager->numAssets && manager->assets[handle - 1].isLoaded);
+}
+
+// Share of the assets queued since loading last started that are uploaded, 1.0 when nothing
+// is loading.
+float GetAssetLoadProgress(AssetManager* manager)
+{
+    if (manager->numPending == 0)
+    {
+        return 1.0f;
+    }
+
+    return (float)(manager->numRequested - manager->numPending) / manager->numRequested;
+}
+
+// Bytes of loaded asset data to keep at most, referenced assets and sprites can go over it.
+void SetAssetMemoryBudget(AssetManager* manager, int budget)
+{
+    manager->memoryBudget = budget;
+}
+
+int GetAssetMemoryUsage(AssetManager* manager)
+{
+    return manager->memoryUsage;
+}
+
+// Watch the files of loaded assets and reload the ones that change.
+void SetAssetHotReload(AssetManager* manager, bool enabled)
+{
+    manager->isHotReloadEnabled = enabled;
+    manager->lastHotReloadTime = GetTime();
+}
+
+// Getters load the asset on first use and return an empty one until it is uploaded.
+Texture2D GetAssetTexture(AssetManager* manager, AssetHandle handle)
+{
+    Asset* asset = UseAsset(manager, handle);
+
+    return (asset != NULL && asset->isLoaded) ? asset->texture : (Texture2D){ 0 };
+}
+
+Image GetAssetImage(AssetManager* manager, AssetHandle handle)
+{
+    Asset* asset = UseAsset(manager, handle);
+
+    return (asset != NULL && asset->isLoaded) ? asset->image : (Image){ 0 };
+}
+
+Sprite GetAssetSprite(AssetManager* manager, AssetHandle handle)
+{
+    Asset* asset = UseAsset(manager, handle);
+
+    if (asset == NULL || asset->isLoaded == false || asset->region.page < 0)
+    {
+        return (Sprite){ 0 };
+    }
+
+    return (Sprite){ GetAtlasTexture(&manager->atlas, asset->region), asset->region.rect };
+}
+
+Font GetAssetFont(AssetManager* manager, AssetHandle handle)
+{
+    Asset* asset = UseAsset(manager, handle);
+
+    return (asset != NULL && asset->isLoaded) ? asset->font : (Font){ 0 };
+}
+
+Sound GetAssetSound(AssetManager* manager, AssetHandle handle)
+{
+    Asset* asset = UseAsset(manager, handle);
+
+    return (asset != NULL && asset->isLoaded) ? asset->sound : (Sound){ 0 };
+}
+
+Music GetAssetMusic(AssetManager* manager, AssetHandle handle)
+{
+    Asset* asset = UseAsset(manager, handle);
+
+    return (asset != NULL && asset->isLoaded) ? asset->music : (Music){ 0 };
+}
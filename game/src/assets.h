@@ -0,0 +1,62 @@
+#ifndef ASSETS_H
+#define ASSETS_H
+
+#include "raylib.h"
+
+#define MAX_ASSETS 1024
+#define ASSET_NONE 0
+
+enum AssetType
+{
+	ASSET_TEXTURE,
+	ASSET_IMAGE,				// Stays in memory as 32-bit RGBA, for building other assets.
+	ASSET_SPRITE,				// Packed into the sprite atlas of the asset manager.
+	ASSET_FONT,
+	ASSET_SOUND,
+	ASSET_MUSIC
+};
+
+// Registered asset file. A handle stays valid as long as the asset manager, whether the asset
+// is loaded or not. Zeroed handles are ASSET_NONE.
+typedef unsigned int AssetHandle;
+
+// Region of an atlas page, drawn like any texture.
+typedef struct Sprite
+{
+	Texture2D texture;
+	Rectangle source;
+
+} Sprite;
+
+// Registry of the asset files of the game, looked up by name. Files are decoded on worker
+// threads, only the GPU and audio device uploads are left for the main thread in
+// UpdateAssetManager().
+//
+// Getters load an asset on first use and return an empty asset until it is uploaded. Loading
+// an asset adds a reference that keeps it loaded. Assets without references stay loaded until
+// the memory budget runs out, the least recently used go first.
+typedef struct AssetManager AssetManager;
+
+AssetManager* LoadAssetManager(int numWorkers);
+void UnloadAssetManager(AssetManager* manager);
+void UpdateAssetManager(AssetManager* manager);
+
+AssetHandle GetAssetHandle(AssetManager* manager, int type, const char* fileName);
+AssetHandle LoadAsset(AssetManager* manager, int type, const char* fileName);
+void UnloadAsset(AssetManager* manager, AssetHandle handle);
+
+bool IsAssetReady(AssetManager* manager, AssetHandle handle);
+float GetAssetLoadProgress(AssetManager* manager);
+
+void SetAssetMemoryBudget(AssetManager* manager, int budget);
+int GetAssetMemoryUsage(AssetManager* manager);
+void SetAssetHotReload(AssetManager* manager, bool enabled);
+
+Texture2D GetAssetTexture(AssetManager* manager, AssetHandle handle);
+Image GetAssetImage(AssetManager* manager, AssetHandle handle);
+Sprite GetAssetSprite(AssetManager* manager, AssetHandle handle);
+Font GetAssetFont(AssetManager* manager, AssetHandle handle);
+Sound GetAssetSound(AssetManager* manager, AssetHandle handle);
+Music GetAssetMusic(AssetManager* manager, AssetHandle handle);
+
+#endif
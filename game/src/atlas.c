@@ -0,0 +1,101 @@
+/**********************************************************************************************
+*
+*   Atlas - Sprite atlas packing
+*
+*   Sprites are packed into horizontal shelves in the order they are added, a sprite that
+*   doesn't fit the shelf width starts the next shelf. Each sprite keeps a transparent border
+*   so point sampled neighbours never bleed into each other.
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+
+#include "atlas.h"
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+#define ATLAS_PADDING 2
+
+//----------------------------------------------------------------------------------
+// Atlas Functions Definition
+//----------------------------------------------------------------------------------
+// Nothing is allocated before the first sprite is added.
+void LoadSpriteAtlas(SpriteAtlas* atlas, int pageSize)
+{
+    *atlas = (SpriteAtlas){ 0 };
+
+    atlas->pageSize = pageSize;
+}
+
+void UnloadSpriteAtlas(SpriteAtlas* atlas)
+{
+    for (int i = 0; i < atlas->numPages; i++)
+    {
+        UnloadTexture(atlas->pages[i]);
+    }
+
+    *atlas = (SpriteAtlas){ 0 };
+}
+
+// Pack and upload a 32-bit RGBA image. Returns false if the sprite is too large or the
+// atlas is out of pages.
+bool AddAtlasSprite(SpriteAtlas* atlas, Image image, AtlasRegion* region)
+{
+    int pageSize = atlas->pageSize;
+
+    if (image.data == NULL || image.width + ATLAS_PADDING * 2 > pageSize || image.height + ATLAS_PADDING * 2 > pageSize)
+    {
+        TraceLog(LOG_WARNING, "ATLAS: Sprite of %dx%d could not be packed", image.width, image.height);
+        return false;
+    }
+
+    // Next shelf, then next page.
+    if (atlas->numPages > 0 && atlas->shelfX + image.width + ATLAS_PADDING > pageSize)
+    {
+        atlas->shelfX = ATLAS_PADDING;
+        atlas->shelfY += atlas->shelfHeight + ATLAS_PADDING;
+        atlas->shelfHeight = 0;
+    }
+
+    if (atlas->numPages == 0 || atlas->shelfY + image.height + ATLAS_PADDING > pageSize)
+    {
+        if (atlas->numPages == MAX_ATLAS_PAGES)
+        {
+            TraceLog(LOG_WARNING, "ATLAS: Out of atlas pages");
+            return false;
+        }
+
+        Image pageImage = GenImageColor(pageSize, pageSize, BLANK);
+
+        atlas->pages[atlas->numPages++] = LoadTextureFromImage(pageImage);
+        atlas->shelfX = ATLAS_PADDING;
+        atlas->shelfY = ATLAS_PADDING;
+        atlas->shelfHeight = 0;
+
+        UnloadImage(pageImage);
+
+        TraceLog(LOG_INFO, "ATLAS: Page %d of %dx%d created", atlas->numPages, pageSize, pageSize);
+    }
+
+    region->page = atlas->numPages - 1;
+    region->rect = (Rectangle){ (float)atlas->shelfX, (float)atlas->shelfY, (float)image.width, (float)image.height };
+
+    UpdateAtlasSprite(atlas, *region, image);
+
+    atlas->shelfX += image.width + ATLAS_PADDING;
+    if (image.height > atlas->shelfHeight) atlas->shelfHeight = image.height;
+
+    return true;
+}
+
+// Replace the pixels of a packed sprite, the image must be the size of the region.
+void UpdateAtlasSprite(SpriteAtlas* atlas, AtlasRegion region, Image image)
+{
+    UpdateTextureRec(atlas->pages[region.page], region.rect, image.data);
+}
+
+Texture2D GetAtlasTexture(SpriteAtlas* atlas, AtlasRegion region)
+{
+    return atlas->pages[region.page];
+}
@@ -0,0 +1,37 @@
+#ifndef ATLAS_H
+#define ATLAS_H
+
+#include "raylib.h"
+
+#define MAX_ATLAS_PAGES 4
+
+typedef struct AtlasRegion
+{
+	int page;
+	Rectangle rect;				// Pixel rectangle on the page, usable as a source rectangle.
+
+} AtlasRegion;
+
+// Sprites packed into a few large textures as they are loaded, so sprites of different units
+// can be drawn without texture switches. Pages are created when the last one is full.
+typedef struct SpriteAtlas
+{
+	Texture2D pages[MAX_ATLAS_PAGES];
+	int numPages;
+	int pageSize;
+
+	int shelfX;					// Where the next sprite goes on the last page.
+	int shelfY;
+	int shelfHeight;
+
+} SpriteAtlas;
+
+void LoadSpriteAtlas(SpriteAtlas* atlas, int pageSize);
+void UnloadSpriteAtlas(SpriteAtlas* atlas);
+
+bool AddAtlasSprite(SpriteAtlas* atlas, Image image, AtlasRegion* region);
+void UpdateAtlasSprite(SpriteAtlas* atlas, AtlasRegion region, Image image);
+
+Texture2D GetAtlasTexture(SpriteAtlas* atlas, AtlasRegion region);
+
+#endif
@@ -0,0 +1,455 @@
+/**********************************************************************************************
+*
+*   Battle - Turn based battle rules
+*
+*   The active unit acts with a single Action: walk to a tile within its speed, optionally
+*   hitting an adjacent enemy from there, or wait. Applying an action ends the turn and
+*   gives the turn to the next unit in initiative order.
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+
+#include "battle.h"
+#include "replay.h"
+
+#include <stdlib.h>
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+#define SPAWN_ZONE_TILES 8
+
+//----------------------------------------------------------------------------------
+// Battle Functions Definition
+//----------------------------------------------------------------------------------
+static void BeginBattleTurn(Battle* battle)
+{
+    battle->activeEntity = PopNextTurn(&battle->turnScheduler, &battle->entities);
+
+    // Units moved since the paths were cached.
+    ClearPathCache(&battle->pathfinder);
+
+    if (battle->activeEntity == ENTITY_NONE)
+    {
+        battle->isFinished = true;
+    }
+}
+
+static void UpdateBattleWinner(Battle* battle)
+{
+    Entities* entities = &battle->entities;
+    int teamUnitCount[BATTLE_TEAMS] = { 0 };
+
+    for (int i = 0; i < entities->numEntities; i++)
+    {
+        if ((entities->flags[i] & ENTITY_FLAG_ALIVE) && entities->types[i] == ENTITY_TYPE_CHARACTER)
+        {
+            teamUnitCount[entities->teamIDs[i]]++;
+        }
+    }
+
+    int numTeamsLeft = 0;
+    int lastTeam = -1;
+
+    for (int i = 0; i < BATTLE_TEAMS; i++)
+    {
+        if (teamUnitCount[i] > 0)
+        {
+            numTeamsLeft++;
+            lastTeam = i;
+        }
+    }
+
+    if (numTeamsLeft <= 1)
+    {
+        battle->isFinished = true;
+        battle->winner = lastTeam;
+    }
+}
+
+static void EndBattleTurn(Battle* battle)
+{
+    int entity = battle->activeEntity;
+
+    if (battle->entities.flags[entity] & ENTITY_FLAG_ALIVE)
+    {
+        ScheduleTurn(&battle->turnScheduler, entity, battle->entities.initiatives[entity]);
+    }
+
+    battle->numTurns++;
+    battle->activeEntity = ENTITY_NONE;
+
+    UpdateBattleWinner(battle);
+
+    if (battle->isFinished == false)
+    {
+        BeginBattleTurn(battle);
+    }
+}
+
+bool LoadBattle(Battle* battle, int width, int height, int maxLoadedChunks, unsigned int seed)
+{
+    *battle = (Battle){ 0 };
+    battle->activeEntity = ENTITY_NONE;
+    battle->winner = -1;
+
+    SeedRng(&battle->spawnRng, seed, RNG_STREAM_SPAWN);
+    SeedRng(&battle->combatRng, seed, RNG_STREAM_COMBAT);
+
+    if (LoadMap(&battle->map, width, height, maxLoadedChunks, seed) == false)
+    {
+        return false;
+    }
+
+    LoadPathfinder(&battle->pathfinder, &battle->map, &battle->entities);
+    LoadEntityGrid(&battle->entityGrid, &battle->entities, width, height);
+
+    // TODO: FIX TEAM ID / SPAWN ID STUFF
+    for (int i = 0; i < BATTLE_TEAMS; i++)
+    {
+        SpawnZone* spawnZone = &battle->spawnZones[i];
+
+        spawnZone->playerID = i;
+        spawnZone->numTiles = (height < SPAWN_ZONE_TILES) ? height : SPAWN_ZONE_TILES;
+
+        // Teams start on opposite map edges, rows under water start from the first tile inland.
+        for (int j = 0; j < spawnZone->numTiles; j++)
+        {
+            int x = i * (width - 1);
+            int step = (i == 0) ? 1 : -1;
+            Tile* tile = GetMapTile(&battle->map, x, j);
+
+            while (tile->walkable == false && abs(x + step - i * (width - 1)) < width / 2)
+            {
+                x += step;
+                tile = GetMapTile(&battle->map, x, j);
+            }
+
+            spawnZone->tiles[j] = GetMapTileIndex(&battle->map, tile);
+        }
+    }
+
+    return true;
+}
+
+void UnloadBattle(Battle* battle)
+{
+    UnloadPathfinder(&battle->pathfinder);
+    UnloadEntityGrid(&battle->entityGrid);
+    UnloadMap(&battle->map);
+    UnloadEntities(&battle->entities);
+    UnloadTurnScheduler(&battle->turnScheduler);
+
+    *battle = (Battle){ 0 };
+    battle->activeEntity = ENTITY_NONE;
+}
+
+// Take over a loaded battle, the destination must not be loaded. The source is left empty.
+void MoveBattle(Battle* battle, Battle* source)
+{
+    *battle = *source;
+    battle->pathfinder.map = &battle->map;
+    battle->pathfinder.entities = &battle->entities;
+    battle->entityGrid.entities = &battle->entities;
+
+    *source = (Battle){ 0 };
+    source->activeEntity = ENTITY_NONE;
+}
+
+// Spawn a character on a free walkable tile of the team's spawn zone. Returns ENTITY_NONE if
+// no such tile was found.
+int SpawnBattleCharacter(Battle* battle, int team, const UnitTemplate* unit)
+{
+    if (battle->recorder != NULL) WriteReplayCharacter(battle->recorder, team, unit);
+
+    SpawnZone* spawnZone = &battle->spawnZones[team];
+    int numTiles = spawnZone->numTiles;
+
+    for (int i = 0; i < numTiles; i++)
+    {
+        int tileIndex = spawnZone->tiles[GetRngValue(&battle->spawnRng, 0, numTiles - 1)];
+        Tile* spawnTile = GetMapTileByIndex(&battle->map, tileIndex);
+
+        if (spawnTile->entity == ENTITY_NONE && spawnTile->walkable)
+        {
+            Entities* entities = &battle->entities;
+            int entity = AddEntity(entities);
+            EntityInfo* info = &entities->infos[entity];
+
+            entities->positions[entity] = GetTileEntityPosition(spawnTile);
+            entities->tileIndices[entity] = tileIndex;
+            entities->teamIDs[entity] = spawnZone->playerID;
+            entities->types[entity] = ENTITY_TYPE_CHARACTER;
+            entities->flags[entity] = ENTITY_FLAG_ACTIVE | ENTITY_FLAG_ALIVE | ENTITY_FLAG_BLOCKING;
+            entities->initiatives[entity] = unit->baseInitiative;
+            entities->healths[entity] = unit->health;
+            entities->maxHealths[entity] = unit->maxHealth;
+
+            info->size = (Vector2){ 1.0f, 1.0f };
+            info->speed = unit->speed;
+            info->minAttack = unit->minAttack;
+            info->maxAttack = unit->maxAttack;
+            TextCopy(info->name, unit->name);
+
+            ScheduleTurn(&battle->turnScheduler, entity, unit->baseInitiative);
+
+            SetTileEntity(&battle->map, spawnTile, entity);
+            UpdateGridEntity(&battle->entityGrid, entity);
+
+            return entity;
+        }
+    }
+
+    return ENTITY_NONE;
+}
+
+// Spawn a tree, rock or other blocking object. Returns ENTITY_NONE if the tile is taken or
+// under water.
+int SpawnBattleObject(Battle* battle, int x, int z)
+{
+    if (battle->recorder != NULL) WriteReplayObject(battle->recorder, x, z);
+
+    Tile* spawnTile = GetMapTile(&battle->map, x, z);
+
+    if (spawnTile == NULL || spawnTile->entity != ENTITY_NONE || spawnTile->walkable == false)
+    {
+        return ENTITY_NONE;
+    }
+
+    Entities* entities = &battle->entities;
+    int entity = AddEntity(entities);
+
+    entities->positions[entity] = GetTileEntityPosition(spawnTile);
+    entities->tileIndices[entity] = GetMapTileIndex(&battle->map, spawnTile);
+    entities->types[entity] = ENTITY_TYPE_TERRAIN_OBJECT;
+    entities->flags[entity] = ENTITY_FLAG_ACTIVE | ENTITY_FLAG_ALIVE | ENTITY_FLAG_BLOCKING;
+    entities->infos[entity].size = (Vector2){ 1.0f, 1.0f };
+
+    SetTileEntity(&battle->map, spawnTile, entity);
+    UpdateGridEntity(&battle->entityGrid, entity);
+
+    return entity;
+}
+
+void KillBattleEntity(Battle* battle, int entity)
+{
+    battle->entities.flags[entity] &= ~(ENTITY_FLAG_ALIVE | ENTITY_FLAG_BLOCKING);
+}
+
+void RemoveBattleEntity(Battle* battle, int entity)
+{
+    SetTileEntity(&battle->map, GetEntityTile(battle, entity), ENTITY_NONE);
+    RemoveGridEntity(&battle->entityGrid, entity);
+    battle->entities.flags[entity] &= ~ENTITY_FLAG_ACTIVE;
+}
+
+// Give the first turn, call once all units are spawned.
+void BeginBattle(Battle* battle)
+{
+    if (battle->recorder != NULL) WriteReplayBegin(battle->recorder);
+
+    UpdateBattleWinner(battle);
+
+    if (battle->isFinished == false)
+    {
+        BeginBattleTurn(battle);
+    }
+}
+
+// Can the active unit take the action?
+bool IsActionValid(Battle* battle, Action action)
+{
+    int entity = action.entity;
+
+    if (battle->isFinished || entity == ENTITY_NONE || entity != battle->activeEntity)
+    {
+        return false;
+    }
+
+    if (action.type == ACTION_WAIT)
+    {
+        return true;
+    }
+
+    if (action.type != ACTION_MOVEMENT && action.type != ACTION_ATTACK_BASIC)
+    {
+        return false;
+    }
+
+    Tile* start = GetEntityTile(battle, entity);
+    Tile* goal = GetMapTileByIndex(&battle->map, action.tileIndex);
+
+    if (goal == NULL || (goal != start && goal->entity != ENTITY_NONE))
+    {
+        return false;
+    }
+
+    if (action.type == ACTION_ATTACK_BASIC)
+    {
+        if (IsBattleTarget(battle, entity, action.target) == false)
+        {
+            return false;
+        }
+
+        // Melee, the target has to be next to the goal tile.
+        Tile* targetTile = GetEntityTile(battle, action.target);
+
+        if (abs(targetTile->x - goal->x) > 1 || abs(targetTile->z - goal->z) > 1)
+        {
+            return false;
+        }
+    }
+
+    return FindPath(&battle->pathfinder, start, goal, battle->entities.infos[entity].speed).isFound;
+}
+
+// Take the action with the active unit and end its turn. Returns false and leaves the
+// battle untouched if the action is not valid.
+bool ApplyAction(Battle* battle, Action action)
+{
+    if (IsActionValid(battle, action) == false)
+    {
+        return false;
+    }
+
+    Entities* entities = &battle->entities;
+    int entity = action.entity;
+
+    if (battle->recorder != NULL) WriteReplayAction(battle->recorder, action);
+
+    battle->lastDamage = 0;
+
+    if (action.type == ACTION_MOVEMENT || action.type == ACTION_ATTACK_BASIC)
+    {
+        Tile* goal = GetMapTileByIndex(&battle->map, action.tileIndex);
+
+        SetTileEntity(&battle->map, GetEntityTile(battle, entity), ENTITY_NONE);
+        entities->tileIndices[entity] = action.tileIndex;
+        entities->positions[entity] = GetTileEntityPosition(goal);
+        SetTileEntity(&battle->map, goal, entity);
+        UpdateGridEntity(&battle->entityGrid, entity);
+    }
+
+    if (action.type == ACTION_ATTACK_BASIC)
+    {
+        int target = action.target;
+        int damage = GetRngValue(&battle->combatRng, entities->infos[entity].minAttack, entities->infos[entity].maxAttack);
+
+        battle->lastDamage = damage;
+
+        entities->healths[target] = entities->healths[target] - damage;
+
+        if (entities->healths[target] <= 0)
+        {
+            entities->healths[target] = 0;
+            KillBattleEntity(battle, target);
+        }
+    }
+
+    EndBattleTurn(battle);
+
+    return true;
+}
+
+// Queue an action for the next UpdateBattle(). Returns false if the queue is full.
+bool QueueBattleAction(Battle* battle, Action action)
+{
+    return PushAction(&battle->actionQueue, action);
+}
+
+// Apply the queued actions in order. Actions that are not valid by the time they are applied,
+// like a second end turn click for a unit whose turn is over, are dropped. Returns the number
+// of actions applied.
+int UpdateBattle(Battle* battle)
+{
+    Action action = { 0 };
+    int numApplied = 0;
+
+    while (PopAction(&battle->actionQueue, &action))
+    {
+        if (ApplyAction(battle, action)) numApplied++;
+    }
+
+    return numApplied;
+}
+
+void SaveBattleSnapshot(Battle* battle, BattleSnapshot* snapshot)
+{
+    CopyEntities(&snapshot->entities, &battle->entities);
+    CopyTurnScheduler(&snapshot->turnScheduler, &battle->turnScheduler);
+
+    snapshot->spawnRng = battle->spawnRng;
+    snapshot->combatRng = battle->combatRng;
+    snapshot->activeEntity = battle->activeEntity;
+    snapshot->numTurns = battle->numTurns;
+    snapshot->lastDamage = battle->lastDamage;
+    snapshot->winner = battle->winner;
+    snapshot->isFinished = battle->isFinished;
+}
+
+void LoadBattleSnapshot(Battle* battle, const BattleSnapshot* snapshot)
+{
+    CopyEntities(&battle->entities, &snapshot->entities);
+    CopyTurnScheduler(&battle->turnScheduler, &snapshot->turnScheduler);
+
+    battle->spawnRng = snapshot->spawnRng;
+    battle->combatRng = snapshot->combatRng;
+    battle->activeEntity = snapshot->activeEntity;
+    battle->numTurns = snapshot->numTurns;
+    battle->lastDamage = snapshot->lastDamage;
+    battle->winner = snapshot->winner;
+    battle->isFinished = snapshot->isFinished;
+
+    // Queued actions were meant for the state being replaced.
+    ClearActionQueue(&battle->actionQueue);
+
+    // The terrain stays, only put the entities back on their tiles.
+    ClearMapEntities(&battle->map);
+    ClearEntityGrid(&battle->entityGrid);
+
+    for (int i = 0; i < battle->entities.numEntities; i++)
+    {
+        if (battle->entities.flags[i] & ENTITY_FLAG_ACTIVE)
+        {
+            SetTileEntity(&battle->map, GetEntityTile(battle, i), i);
+            UpdateGridEntity(&battle->entityGrid, i);
+        }
+    }
+
+    ClearPathCache(&battle->pathfinder);
+}
+
+void UnloadBattleSnapshot(BattleSnapshot* snapshot)
+{
+    UnloadEntities(&snapshot->entities);
+    UnloadTurnScheduler(&snapshot->turnScheduler);
+
+    *snapshot = (BattleSnapshot){ 0 };
+}
+
+Tile* GetEntityTile(Battle* battle, int entity)
+{
+    return GetMapTileByIndex(&battle->map, battle->entities.tileIndices[entity]);
+}
+
+bool IsBattleEnemy(Battle* battle, int entity, int other)
+{
+    return battle->entities.teamIDs[entity] != battle->entities.teamIDs[other];
+}
+
+// Can the entity attack the target at all, range aside?
+bool IsBattleTarget(Battle* battle, int entity, int target)
+{
+    Entities* entities = &battle->entities;
+
+    if (target < 0 || target >= entities->numEntities || target == entity)
+    {
+        return false;
+    }
+
+    return entities->types[target] == ENTITY_TYPE_CHARACTER &&
+        (entities->flags[target] & ENTITY_FLAG_ACTIVE) &&
+        (entities->flags[target] & ENTITY_FLAG_ALIVE) &&
+        IsBattleEnemy(battle, entity, target);
+}
@@ -0,0 +1,95 @@
+#ifndef BATTLE_H
+#define BATTLE_H
+
+#include "raylib.h"
+#include "level.h"
+#include "entity.h"
+#include "entity_grid.h"
+#include "action.h"
+#include "pathfinding.h"
+#include "turn_scheduler.h"
+#include "rng.h"
+
+#define BATTLE_TEAMS 2
+
+typedef struct ReplayWriter ReplayWriter;
+
+// Stats of a spawned character.
+typedef struct UnitTemplate
+{
+	const char* name;
+	int speed;
+	int baseInitiative;
+	int health;
+	int maxHealth;
+	int minAttack;
+	int maxAttack;
+
+} UnitTemplate;
+
+// Complete state of one battle. Pure game logic, needs no window, input or audio, so the
+// same rules run in the game and in the headless simulator. The pathfinder and the entity
+// grid point into the battle, move a loaded battle only with MoveBattle().
+typedef struct Battle
+{
+	Map map;
+	Entities entities;
+	EntityGrid entityGrid;		// Active entities by map cell, follows their tiles.
+	Pathfinder pathfinder;
+	TurnScheduler turnScheduler;
+	SpawnZone spawnZones[BATTLE_TEAMS];
+	Rng spawnRng;				// Streams of the battle seed, see RngStream.
+	Rng combatRng;
+
+	int activeEntity;			// Unit taking its turn, ENTITY_NONE before the battle starts.
+	int numTurns;
+	int lastDamage;				// Damage rolled by the last applied action, 0 if it didn't attack.
+	int winner;					// Last team standing, -1 while running or if nobody is left.
+	bool isFinished;
+
+	ActionQueue actionQueue;	// Applied by UpdateBattle().
+	ReplayWriter* recorder;		// Spawns and actions are recorded here when set.
+
+} Battle;
+
+// Everything in a battle that changes after it is loaded. The map comes from the battle
+// seed, so a snapshot can only be loaded back into a battle with the same seed and size.
+typedef struct BattleSnapshot
+{
+	Entities entities;
+	TurnScheduler turnScheduler;
+	Rng spawnRng;
+	Rng combatRng;
+
+	int activeEntity;
+	int numTurns;
+	int lastDamage;
+	int winner;
+	bool isFinished;
+
+} BattleSnapshot;
+
+bool LoadBattle(Battle* battle, int width, int height, int maxLoadedChunks, unsigned int seed);
+void UnloadBattle(Battle* battle);
+void MoveBattle(Battle* battle, Battle* source);
+
+int SpawnBattleCharacter(Battle* battle, int team, const UnitTemplate* unit);
+int SpawnBattleObject(Battle* battle, int x, int z);
+void KillBattleEntity(Battle* battle, int entity);
+void RemoveBattleEntity(Battle* battle, int entity);
+
+void BeginBattle(Battle* battle);
+bool IsActionValid(Battle* battle, Action action);
+bool ApplyAction(Battle* battle, Action action);
+bool QueueBattleAction(Battle* battle, Action action);
+int UpdateBattle(Battle* battle);
+
+void SaveBattleSnapshot(Battle* battle, BattleSnapshot* snapshot);
+void LoadBattleSnapshot(Battle* battle, const BattleSnapshot* snapshot);
+void UnloadBattleSnapshot(BattleSnapshot* snapshot);
+
+Tile* GetEntityTile(Battle* battle, int entity);
+bool IsBattleEnemy(Battle* battle, int entity, int other);
+bool IsBattleTarget(Battle* battle, int entity, int target);
+
+#endif
@@ -0,0 +1,415 @@
+/**********************************************************************************************
+*
+*   Battle Save - Versioned binary battle state
+*
+*   Entities and turns refer to each other by entity id and map tile index, never by pointer,
+*   so their arrays are written out as they are. The only pointers are the spawn zone tiles
+*   and the entity of each tile: spawn zones are saved as tile indices and tiles are filled
+*   in from the entity tile indices on load. Terrain is not saved, it is generated from the
+*   seed like in any other battle.
+*
+*   The file is a fixed header followed by one section per array, each 16 byte aligned so
+*   the arrays can be copied straight out of the mapped file.
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+
+#include "battle_save.h"
+#include "mapped_file.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+#define SAVE_BYTE_ORDER 0x01020304      // Reads back as 0x04030201 on the other endianness.
+#define SAVE_SECTION_ALIGNMENT 16
+
+enum SaveSection
+{
+    SAVE_SECTION_POSITIONS,
+    SAVE_SECTION_TILE_INDICES,
+    SAVE_SECTION_TEAM_IDS,
+    SAVE_SECTION_TYPES,
+    SAVE_SECTION_FLAGS,
+    SAVE_SECTION_INITIATIVES,
+    SAVE_SECTION_HEALTHS,
+    SAVE_SECTION_MAX_HEALTHS,
+    SAVE_SECTION_INFOS,
+    SAVE_SECTION_TURN_ENTRIES,
+    SAVE_SECTION_SPAWN_TILES,
+    SAVE_SECTION_COUNT
+};
+
+typedef struct SaveHeader
+{
+    char magic[4];
+    uint16_t version;
+    uint16_t headerSize;
+    uint32_t byteOrder;
+    uint16_t entityInfoSize;        // Struct sizes, a changed layout can't be loaded.
+    uint16_t turnEntrySize;
+
+    uint32_t seed;
+    int32_t width;
+    int32_t height;
+
+    int32_t numEntities;
+    int32_t numTurnEntries;
+    int32_t numSpawnTiles[BATTLE_TEAMS];
+    int32_t turnTime;
+    uint32_t turnOrder;
+
+    int32_t activeEntity;
+    int32_t numTurns;
+    int32_t lastDamage;
+    int32_t winner;
+    int32_t isFinished;
+
+    Rng spawnRng;
+    Rng combatRng;
+
+    uint32_t sectionOffsets[SAVE_SECTION_COUNT];
+    uint32_t sectionSizes[SAVE_SECTION_COUNT];
+
+} SaveHeader;
+
+static const char saveMagic[4] = { 'H', 'B', 'T', 'L' };
+
+//----------------------------------------------------------------------------------
+// Battle Save Functions Definition
+//----------------------------------------------------------------------------------
+static uint32_t AlignSaveOffset(uint32_t offset)
+{
+    return (offset + SAVE_SECTION_ALIGNMENT - 1) & ~(uint32_t)(SAVE_SECTION_ALIGNMENT - 1);
+}
+
+// Section sizes a header has to have, from its counts.
+static void GetSaveSectionSizes(const SaveHeader* header, uint32_t* sizes)
+{
+    uint32_t numEntities = (uint32_t)header->numEntities;
+
+    sizes[SAVE_SECTION_POSITIONS] = numEntities * sizeof(Vector3);
+    sizes[SAVE_SECTION_TILE_INDICES] = numEntities * sizeof(int);
+    sizes[SAVE_SECTION_TEAM_IDS] = numEntities * sizeof(int);
+    sizes[SAVE_SECTION_TYPES] = numEntities * sizeof(unsigned char);
+    sizes[SAVE_SECTION_FLAGS] = numEntities * sizeof(unsigned char);
+    sizes[SAVE_SECTION_INITIATIVES] = numEntities * sizeof(int);
+    sizes[SAVE_SECTION_HEALTHS] = numEntities * sizeof(int);
+    sizes[SAVE_SECTION_MAX_HEALTHS] = numEntities * sizeof(int);
+    sizes[SAVE_SECTION_INFOS] = numEntities * sizeof(EntityInfo);
+    sizes[SAVE_SECTION_TURN_ENTRIES] = (uint32_t)header->numTurnEntries * sizeof(TurnEntry);
+    sizes[SAVE_SECTION_SPAWN_TILES] = 0;
+
+    for (int i = 0; i < BATTLE_TEAMS; i++)
+    {
+        sizes[SAVE_SECTION_SPAWN_TILES] += (uint32_t)header->numSpawnTiles[i] * sizeof(int);
+    }
+}
+
+bool SaveBattleState(Battle* battle, const char* fileName)
+{
+    Entities* entities = &battle->entities;
+    SaveHeader header = { 0 };
+    int spawnTiles[BATTLE_TEAMS * SPAWN_ZONE_MAX_TILES] = { 0 };
+    int numSpawnTiles = 0;
+
+    memcpy(header.magic, saveMagic, sizeof(saveMagic));
+    header.version = BATTLE_SAVE_VERSION;
+    header.headerSize = sizeof(SaveHeader);
+    header.byteOrder = SAVE_BYTE_ORDER;
+    header.entityInfoSize = sizeof(EntityInfo);
+    header.turnEntrySize = sizeof(TurnEntry);
+
+    header.seed = battle->map.seed;
+    header.width = battle->map.width;
+    header.height = battle->map.height;
+
+    header.numEntities = entities->numEntities;
+    header.numTurnEntries = battle->turnScheduler.numEntries;
+    header.turnTime = battle->turnScheduler.time;
+    header.turnOrder = battle->turnScheduler.nextOrder;
+
+    header.activeEntity = battle->activeEntity;
+    header.numTurns = battle->numTurns;
+    header.lastDamage = battle->lastDamage;
+    header.winner = battle->winner;
+    header.isFinished = battle->isFinished;
+
+    header.spawnRng = battle->spawnRng;
+    header.combatRng = battle->combatRng;
+
+    for (int i = 0; i < BATTLE_TEAMS; i++)
+    {
+        SpawnZone* spawnZone = &battle->spawnZones[i];
+
+        header.numSpawnTiles[i] = spawnZone->numTiles;
+
+        for (int j = 0; j < spawnZone->numTiles; j++)
+        {
+            spawnTiles[numSpawnTiles++] = spawnZone->tiles[j];
+        }
+    }
+
+    const void* sectionData[SAVE_SECTION_COUNT] = {
+        entities->positions, entities->tileIndices, entities->teamIDs, entities->types, entities->flags,
+        entities->initiatives, entities->healths, entities->maxHealths, entities->infos,
+        battle->turnScheduler.entries, spawnTiles
+    };
+
+    GetSaveSectionSizes(&header, header.sectionSizes);
+
+    uint32_t offset = AlignSaveOffset(sizeof(SaveHeader));
+
+    for (int i = 0; i < SAVE_SECTION_COUNT; i++)
+    {
+        header.sectionOffsets[i] = offset;
+        offset = AlignSaveOffset(offset + header.sectionSizes[i]);
+    }
+
+    FILE* file = fopen(fileName, "wb");
+
+    if (file == NULL)
+    {
+        TraceLog(LOG_WARNING, "BATTLE: [%s] Failed to open file for writing", fileName);
+        return false;
+    }
+
+    static const unsigned char padding[SAVE_SECTION_ALIGNMENT] = { 0 };
+    bool isWritten = (fwrite(&header, sizeof(SaveHeader), 1, file) == 1);
+    uint32_t position = sizeof(SaveHeader);
+
+    for (int i = 0; i < SAVE_SECTION_COUNT && isWritten; i++)
+    {
+        uint32_t size = header.sectionSizes[i];
+
+        isWritten = (fwrite(padding, 1, header.sectionOffsets[i] - position, file) == header.sectionOffsets[i] - position);
+
+        if (isWritten && size > 0)
+        {
+            isWritten = (fwrite(sectionData[i], 1, size, file) == size);
+        }
+
+        position = header.sectionOffsets[i] + size;
+    }
+
+    if (fclose(file) != 0 || isWritten == false)
+    {
+        TraceLog(LOG_WARNING, "BATTLE: [%s] Failed to write battle", fileName);
+        return false;
+    }
+
+    TraceLog(LOG_INFO, "BATTLE: [%s] Battle saved successfully (%i entities, %u bytes)", fileName, entities->numEntities, (unsigned int)position);
+
+    return true;
+}
+
+static bool IsSaveHeaderValid(const SaveHeader* header, size_t fileSize)
+{
+    if (fileSize < sizeof(SaveHeader) || memcmp(header->magic, saveMagic, sizeof(saveMagic)) != 0)
+    {
+        return false;
+    }
+
+    if (header->version != BATTLE_SAVE_VERSION || header->headerSize != sizeof(SaveHeader) || header->byteOrder != SAVE_BYTE_ORDER ||
+        header->entityInfoSize != sizeof(EntityInfo) || header->turnEntrySize != sizeof(TurnEntry))
+    {
+        return false;
+    }
+
+    if (header->width <= 0 || header->height <= 0 || (long long)header->width * header->height > INT_MAX)
+    {
+        return false;
+    }
+
+    // Limits keep the section sizes from overflowing, the file size limits them further.
+    if (header->numEntities < 0 || header->numEntities > (int)(UINT32_MAX / sizeof(EntityInfo)) ||
+        header->numTurnEntries < 0 || header->numTurnEntries > (int)(UINT32_MAX / sizeof(TurnEntry)))
+    {
+        return false;
+    }
+
+    for (int i = 0; i < BATTLE_TEAMS; i++)
+    {
+        if (header->numSpawnTiles[i] < 0 || header->numSpawnTiles[i] > SPAWN_ZONE_MAX_TILES)
+        {
+            return false;
+        }
+    }
+
+    uint32_t sizes[SAVE_SECTION_COUNT] = { 0 };
+    GetSaveSectionSizes(header, sizes);
+
+    for (int i = 0; i < SAVE_SECTION_COUNT; i++)
+    {
+        uint32_t offset = header->sectionOffsets[i];
+
+        if (header->sectionSizes[i] != sizes[i] || offset % SAVE_SECTION_ALIGNMENT != 0 || offset > fileSize || sizes[i] > fileSize - offset)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static const void* GetSaveSection(const MappedFile* file, int section)
+{
+    const SaveHeader* header = (const SaveHeader*)file->data;
+
+    return file->data + header->sectionOffsets[section];
+}
+
+// Every id and tile index has to be in range, the battle trusts them without checks.
+static bool IsSaveDataValid(const SaveHeader* header, const Entities* entities, const TurnScheduler* scheduler, const int* spawnTiles)
+{
+    int numEntities = entities->numEntities;
+    int numTiles = header->width * header->height;
+    int numSpawnTiles = 0;
+
+    for (int i = 0; i < numEntities; i++)
+    {
+        // Removed entities keep their last tile, the active entity and turn entries can still
+        // name them.
+        if (entities->tileIndices[i] < 0 || entities->tileIndices[i] >= numTiles)
+        {
+            return false;
+        }
+
+        if (entities->types[i] == ENTITY_TYPE_CHARACTER && (entities->teamIDs[i] < 0 || entities->teamIDs[i] >= BATTLE_TEAMS))
+        {
+            return false;
+        }
+
+        if (entities->infos[i].sprite < 0 || entities->infos[i].sprite >= SPRITE_COUNT ||
+            entities->infos[i].deathSprite < 0 || entities->infos[i].deathSprite >= SPRITE_COUNT)
+        {
+            return false;
+        }
+    }
+
+    for (int i = 0; i < scheduler->numEntries; i++)
+    {
+        if (scheduler->entries[i].entity < 0 || scheduler->entries[i].entity >= numEntities)
+        {
+            return false;
+        }
+    }
+
+    for (int i = 0; i < BATTLE_TEAMS; i++)
+    {
+        numSpawnTiles += header->numSpawnTiles[i];
+    }
+
+    for (int i = 0; i < numSpawnTiles; i++)
+    {
+        if (spawnTiles[i] < 0 || spawnTiles[i] >= numTiles)
+        {
+            return false;
+        }
+    }
+
+    return (header->activeEntity >= ENTITY_NONE && header->activeEntity < numEntities && header->winner >= -1 && header->winner < BATTLE_TEAMS);
+}
+
+// Replace the battle with a saved one. The battle is left as it was if the file can't be
+// loaded.
+bool LoadBattleState(Battle* battle, const char* fileName, int maxLoadedChunks)
+{
+    MappedFile file = { 0 };
+
+    if (OpenMappedFile(&file, fileName) == false)
+    {
+        TraceLog(LOG_WARNING, "BATTLE: [%s] Failed to open file", fileName);
+        return false;
+    }
+
+    const SaveHeader* header = (const SaveHeader*)file.data;
+
+    if (IsSaveHeaderValid(header, file.size) == false)
+    {
+        TraceLog(LOG_WARNING, "BATTLE: [%s] Not a battle save or saved by another version", fileName);
+
+        CloseMappedFile(&file);
+        return false;
+    }
+
+    // Views into the mapped file, only ever read from.
+    BattleSnapshot snapshot = { 0 };
+
+    snapshot.entities.positions = (Vector3*)GetSaveSection(&file, SAVE_SECTION_POSITIONS);
+    snapshot.entities.tileIndices = (int*)GetSaveSection(&file, SAVE_SECTION_TILE_INDICES);
+    snapshot.entities.teamIDs = (int*)GetSaveSection(&file, SAVE_SECTION_TEAM_IDS);
+    snapshot.entities.types = (unsigned char*)GetSaveSection(&file, SAVE_SECTION_TYPES);
+    snapshot.entities.flags = (unsigned char*)GetSaveSection(&file, SAVE_SECTION_FLAGS);
+    snapshot.entities.initiatives = (int*)GetSaveSection(&file, SAVE_SECTION_INITIATIVES);
+    snapshot.entities.healths = (int*)GetSaveSection(&file, SAVE_SECTION_HEALTHS);
+    snapshot.entities.maxHealths = (int*)GetSaveSection(&file, SAVE_SECTION_MAX_HEALTHS);
+    snapshot.entities.infos = (EntityInfo*)GetSaveSection(&file, SAVE_SECTION_INFOS);
+    snapshot.entities.numEntities = header->numEntities;
+
+    snapshot.turnScheduler.entries = (TurnEntry*)GetSaveSection(&file, SAVE_SECTION_TURN_ENTRIES);
+    snapshot.turnScheduler.numEntries = header->numTurnEntries;
+    snapshot.turnScheduler.time = header->turnTime;
+    snapshot.turnScheduler.nextOrder = header->turnOrder;
+
+    const int* spawnTiles = (const int*)GetSaveSection(&file, SAVE_SECTION_SPAWN_TILES);
+
+    snapshot.spawnRng = header->spawnRng;
+    snapshot.combatRng = header->combatRng;
+    snapshot.activeEntity = header->activeEntity;
+    snapshot.numTurns = header->numTurns;
+    snapshot.lastDamage = header->lastDamage;
+    snapshot.winner = header->winner;
+    snapshot.isFinished = (header->isFinished != 0);
+
+    if (IsSaveDataValid(header, &snapshot.entities, &snapshot.turnScheduler, spawnTiles) == false)
+    {
+        TraceLog(LOG_WARNING, "BATTLE: [%s] Battle data is corrupted", fileName);
+
+        CloseMappedFile(&file);
+        return false;
+    }
+
+    // Built aside and swapped in, so a failure leaves the current battle running.
+    Battle loadedBattle = { 0 };
+
+    if (LoadBattle(&loadedBattle, header->width, header->height, maxLoadedChunks, header->seed) == false)
+    {
+        CloseMappedFile(&file);
+        return false;
+    }
+
+    LoadBattleSnapshot(&loadedBattle, &snapshot);
+
+    for (int i = 0; i < BATTLE_TEAMS; i++)
+    {
+        SpawnZone* spawnZone = &loadedBattle.spawnZones[i];
+
+        spawnZone->numTiles = header->numSpawnTiles[i];
+
+        for (int j = 0; j < spawnZone->numTiles; j++)
+        {
+            spawnZone->tiles[j] = *spawnTiles++;
+        }
+    }
+
+    for (int i = 0; i < loadedBattle.entities.numEntities; i++)
+    {
+        EntityInfo* info = &loadedBattle.entities.infos[i];
+
+        info->name[sizeof(info->name) - 1] = '\0';
+    }
+
+    UnloadBattle(battle);
+    MoveBattle(battle, &loadedBattle);
+
+    TraceLog(LOG_INFO, "BATTLE: [%s] Battle loaded successfully (%i entities)", fileName, battle->entities.numEntities);
+
+    CloseMappedFile(&file);
+
+    return true;
+}
@@ -0,0 +1,14 @@
+#ifndef BATTLE_SAVE_H
+#define BATTLE_SAVE_H
+
+#include "battle.h"
+
+#define BATTLE_SAVE_VERSION 3
+
+// Whole battle state in one binary file. Arrays are stored as they are in memory, so loading
+// is a few block copies out of the mapped file. Only files saved by a build with the same
+// version, byte order and struct layout load.
+bool SaveBattleState(Battle* battle, const char* fileName);
+bool LoadBattleState(Battle* battle, const char* fileName, int maxLoadedChunks);
+
+#endif
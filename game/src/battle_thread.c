@@ -0,0 +1,283 @@
+/**********************************************************************************************
+*
+*   Battle Thread - Battle simulation off the main thread
+*
+*   The battle thread owns the battle. Other threads queue actions and read frames, or lock
+*   the battle for the rare direct change, like loading a saved game.
+*
+*   Frames are triple buffered: the thread writes its back frame, then swaps it with the
+*   middle one and marks it fresh. The reader swaps its front frame with a fresh middle one.
+*   Each side only ever touches its own frame, a single atomic exchange hands frames over.
+*
+**********************************************************************************************/
+
+#include "battle_thread.h"
+#include "ai.h"
+#include "threads.h"
+
+#include <stdlib.h>
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+#define FRAME_FRESH 4       // Set in middleFrame when the writer swapped in a frame not yet read.
+
+struct BattleThread
+{
+    Battle* battle;
+    bool isAiTeam[BATTLE_TEAMS];
+    Thread thread;
+    ThreadPool* aiPool;             // AI turns search their actions on every core.
+    AiWorkers* aiWorkers;
+
+    Mutex battleLock;               // Held while the battle is changed.
+    Mutex queueLock;                // Guards the members below.
+    Condition queueCondition;
+    ActionQueue queue;
+    unsigned int numActions;
+    bool isWakeRequested;
+    bool isStopping;
+
+    BattleFrame frames[3];
+    int backFrame;                  // Only touched while holding battleLock, like the two below.
+    unsigned int version;
+    unsigned int numAppliedActions;
+    int frontFrame;                 // Only touched by the reader.
+    volatile long middleFrame;      // Frame index, FRAME_FRESH bit. Only accessed atomically.
+};
+
+//----------------------------------------------------------------------------------
+// Battle Thread Functions Definition
+//----------------------------------------------------------------------------------
+// Copy the battle to the back frame and hand it to the reader. Call with battleLock held.
+static void PublishBattleFrame(BattleThread* thread)
+{
+    Battle* battle = thread->battle;
+    BattleFrame* frame = &thread->frames[thread->backFrame];
+
+    SaveBattleSnapshot(battle, &frame->battle);
+
+    // Moves of the next unit, so the reader doesn't have to search them.
+    frame->numReachableTiles = 0;
+
+    if (battle->activeEntity != ENTITY_NONE)
+    {
+        Pathfinder* pathfinder = &battle->pathfinder;
+        int entity = battle->activeEntity;
+
+        FindReachableTiles(pathfinder, GetEntityTile(battle, entity), battle->entities.infos[entity].speed);
+
+        if (pathfinder->numReachableTiles > frame->maxReachableTiles)
+        {
+            frame->maxReachableTiles = pathfinder->numReachableTiles;
+            frame->reachableTiles = (int*)MemRealloc(frame->reachableTiles, frame->maxReachableTiles * sizeof(int));
+        }
+
+        for (int i = 0; i < pathfinder->numReachableTiles; i++)
+        {
+            frame->reachableTiles[i] = GetMapTileIndex(&battle->map, pathfinder->reachableTiles[i]);
+        }
+
+        frame->numReachableTiles = pathfinder->numReachableTiles;
+
+        EvictMapChunks(&battle->map, GetEntityTile(battle, entity)->x, GetEntityTile(battle, entity)->z);
+    }
+
+    frame->version = ++thread->version;
+    frame->numActions = thread->numAppliedActions;
+
+    thread->backFrame = (int)(ExchangeAtomic(&thread->middleFrame, thread->backFrame | FRAME_FRESH) & ~FRAME_FRESH);
+}
+
+static bool IsAiTurn(BattleThread* thread)
+{
+    Battle* battle = thread->battle;
+
+    return (battle->isFinished == false && battle->activeEntity != ENTITY_NONE &&
+        thread->isAiTeam[battle->entities.teamIDs[battle->activeEntity]]);
+}
+
+static bool IsBattleThreadStopping(BattleThread* thread)
+{
+    LockMutex(&thread->queueLock);
+    bool isStopping = thread->isStopping;
+    UnlockMutex(&thread->queueLock);
+
+    return isStopping;
+}
+
+static void RunBattleThread(void* data)
+{
+    BattleThread* thread = (BattleThread*)data;
+    Battle* battle = thread->battle;
+
+    for (;;)
+    {
+        ActionQueue actions = { 0 };
+        Action action = { 0 };
+
+        LockMutex(&thread->queueLock);
+
+        while (thread->isStopping == false && thread->queue.numActions == 0 && thread->isWakeRequested == false)
+        {
+            WaitCondition(&thread->queueCondition, &thread->queueLock);
+        }
+
+        if (thread->isStopping)
+        {
+            UnlockMutex(&thread->queueLock);
+            break;
+        }
+
+        while (PopAction(&thread->queue, &action)) PushAction(&actions, action);
+
+        unsigned int numActions = thread->numActions;
+        thread->isWakeRequested = false;
+
+        UnlockMutex(&thread->queueLock);
+
+        LockMutex(&thread->battleLock);
+
+        while (PopAction(&actions, &action)) QueueBattleAction(battle, action);
+
+        UpdateBattle(battle);
+        thread->numAppliedActions = numActions;
+        PublishBattleFrame(thread);
+
+        // AI units play until it is someone else's turn. Every turn gets a frame of its own.
+        while (IsAiTurn(thread) && IsBattleThreadStopping(thread) == false)
+        {
+            QueueBattleAction(battle, ChooseParallelSearchAction(thread->aiWorkers, battle, (AiSearchLimits){ AI_MAX_DEPTH, 0, AI_TIME_BUDGET }));
+
+            if (UpdateBattle(battle) == 0)
+            {
+                QueueBattleAction(battle, (Action){ ACTION_WAIT, battle->activeEntity, -1, ENTITY_NONE });
+                UpdateBattle(battle);
+            }
+
+            PublishBattleFrame(thread);
+        }
+
+        UnlockMutex(&thread->battleLock);
+    }
+}
+
+// Start running the battle, it belongs to the thread until UnloadBattleThread(). Units of
+// the teams set in isAiTeam are played by the AI, isAiTeam can be NULL.
+BattleThread* LoadBattleThread(Battle* battle, const bool* isAiTeam)
+{
+    BattleThread* thread = (BattleThread*)MemAlloc(sizeof(BattleThread));
+
+    thread->battle = battle;
+    thread->backFrame = 0;
+    thread->middleFrame = 1;
+    thread->frontFrame = 2;
+
+    for (int i = 0; i < BATTLE_TEAMS; i++)
+    {
+        thread->isAiTeam[i] = (isAiTeam != NULL) ? isAiTeam[i] : false;
+
+        if (thread->isAiTeam[i] && thread->aiPool == NULL)
+        {
+            thread->aiPool = LoadThreadPool(0);
+            thread->aiWorkers = LoadAiWorkers(thread->aiPool);
+        }
+    }
+
+    InitMutex(&thread->battleLock);
+    InitMutex(&thread->queueLock);
+    InitCondition(&thread->queueCondition);
+
+    // The first frame is ready before anyone asks, an AI turn first thing wakes the thread.
+    PublishBattleFrame(thread);
+    thread->isWakeRequested = IsAiTurn(thread);
+
+    StartThread(&thread->thread, RunBattleThread, thread);
+
+    return thread;
+}
+
+// Stop the thread, the battle belongs to the caller again.
+void UnloadBattleThread(BattleThread* thread)
+{
+    if (thread == NULL)
+    {
+        return;
+    }
+
+    LockMutex(&thread->queueLock);
+    thread->isStopping = true;
+    SignalCondition(&thread->queueCondition);
+    UnlockMutex(&thread->queueLock);
+
+    JoinThread(&thread->thread);
+
+    for (int i = 0; i < 3; i++)
+    {
+        UnloadBattleSnapshot(&thread->frames[i].battle);
+        MemFree(thread->frames[i].reachableTiles);
+    }
+
+    if (thread->aiPool != NULL)
+    {
+        UnloadAiWorkers(thread->aiWorkers);
+        UnloadThreadPool(thread->aiPool);
+    }
+
+    DestroyCondition(&thread->queueCondition);
+    DestroyMutex(&thread->queueLock);
+    DestroyMutex(&thread->battleLock);
+
+    MemFree(thread);
+}
+
+// Returns false if the queue is full and the action was dropped.
+bool QueueBattleThreadAction(BattleThread* thread, Action action)
+{
+    LockMutex(&thread->queueLock);
+
+    bool isQueued = PushAction(&thread->queue, action);
+
+    if (isQueued)
+    {
+        thread->numActions++;
+        SignalCondition(&thread->queueCondition);
+    }
+
+    UnlockMutex(&thread->queueLock);
+
+    return isQueued;
+}
+
+// Latest published frame. It stays valid and unchanged until the next call, only one thread
+// may read frames.
+const BattleFrame* GetBattleFrame(BattleThread* thread)
+{
+    if (LoadAtomic(&thread->middleFrame) & FRAME_FRESH)
+    {
+        thread->frontFrame = (int)(ExchangeAtomic(&thread->middleFrame, thread->frontFrame) & ~FRAME_FRESH);
+    }
+
+    return &thread->frames[thread->frontFrame];
+}
+
+// Wait for the thread to finish what it is doing and take the battle. The thread publishes
+// a new frame of whatever was changed on unlock.
+Battle* LockBattleThread(BattleThread* thread)
+{
+    LockMutex(&thread->battleLock);
+
+    return thread->battle;
+}
+
+void UnlockBattleThread(BattleThread* thread)
+{
+    PublishBattleFrame(thread);
+    UnlockMutex(&thread->battleLock);
+
+    // The change may have given the turn to an AI unit.
+    LockMutex(&thread->queueLock);
+    thread->isWakeRequested = true;
+    SignalCondition(&thread->queueCondition);
+    UnlockMutex(&thread->queueLock);
+}
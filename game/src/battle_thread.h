@@ -0,0 +1,34 @@
+#ifndef BATTLE_THREAD_H
+#define BATTLE_THREAD_H
+
+#include "battle.h"
+
+// State of the battle after one update, published by the battle thread for drawing.
+typedef struct BattleFrame
+{
+	BattleSnapshot battle;
+
+	int* reachableTiles;		// Tile indices the active unit can move to.
+	int numReachableTiles;
+	int maxReachableTiles;
+
+	unsigned int version;		// Changes with every published frame.
+	unsigned int numActions;	// Queued actions taken so far, applied or dropped.
+
+} BattleFrame;
+
+// Runs a battle on a thread of its own: queued actions, AI turns and the pathfinding for the
+// next turn. Frames go through a triple buffer, so publishing and reading never wait for each
+// other and a long AI turn never holds up drawing.
+typedef struct BattleThread BattleThread;
+
+BattleThread* LoadBattleThread(Battle* battle, const bool* isAiTeam);
+void UnloadBattleThread(BattleThread* thread);
+
+bool QueueBattleThreadAction(BattleThread* thread, Action action);
+const BattleFrame* GetBattleFrame(BattleThread* thread);
+
+Battle* LockBattleThread(BattleThread* thread);
+void UnlockBattleThread(BattleThread* thread);
+
+#endif
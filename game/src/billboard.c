@@ -0,0 +1,86 @@
+/**********************************************************************************************
+*
+*   Billboard - Batched camera facing quads
+*
+*   Same quad layout as DrawBillboardPro() with a zero origin and no rotation, minus the view
+*   matrix rebuild and the texture switch back to the default texture for every quad.
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "rlgl.h"
+#include "raymath.h"
+
+#include "billboard.h"
+
+//----------------------------------------------------------------------------------
+// Billboard Functions Definition
+//----------------------------------------------------------------------------------
+void BeginBillboards(BillboardBatch* batch, Camera camera, Vector3 up)
+{
+    Vector3 cameraVector = Vector3Normalize(Vector3Subtract(camera.position, camera.target));
+
+    batch->right = Vector3Normalize(Vector3CrossProduct(camera.up, cameraVector));
+    batch->up = up;
+    batch->textureId = 0;
+    batch->isDrawing = false;
+    batch->numQuads = 0;
+    batch->numTextureSwitches = 0;
+}
+
+// Quad from position along the camera right and the batch up vector, like DrawBillboardPro().
+void AddBillboard(BillboardBatch* batch, Texture2D texture, Rectangle source, Vector3 position, Vector2 size, Color tint)
+{
+    if (batch->isDrawing == false || batch->textureId != texture.id)
+    {
+        if (batch->isDrawing) rlEnd();
+
+        rlSetTexture(texture.id);
+        rlBegin(RL_QUADS);
+
+        batch->textureId = texture.id;
+        batch->isDrawing = true;
+        batch->numTextureSwitches++;
+    }
+
+    Vector3 right = Vector3Scale(batch->right, size.x);
+    Vector3 up = Vector3Scale(batch->up, size.y);
+
+    Vector3 topRight = Vector3Add(Vector3Add(position, right), up);
+    Vector3 bottomRight = Vector3Add(position, right);
+    Vector3 topLeft = Vector3Add(position, up);
+
+    float left = source.x / texture.width;
+    float rightU = (source.x + source.width) / texture.width;
+    float top = source.y / texture.height;
+    float bottom = (source.y + source.height) / texture.height;
+
+    rlCheckRenderBatchLimit(4);
+
+    rlColor4ub(tint.r, tint.g, tint.b, tint.a);
+
+    rlTexCoord2f(left, bottom);
+    rlVertex3f(position.x, position.y, position.z);
+
+    rlTexCoord2f(rightU, bottom);
+    rlVertex3f(bottomRight.x, bottomRight.y, bottomRight.z);
+
+    rlTexCoord2f(rightU, top);
+    rlVertex3f(topRight.x, topRight.y, topRight.z);
+
+    rlTexCoord2f(left, top);
+    rlVertex3f(topLeft.x, topLeft.y, topLeft.z);
+
+    batch->numQuads++;
+}
+
+void EndBillboards(BillboardBatch* batch)
+{
+    if (batch->isDrawing)
+    {
+        rlEnd();
+        rlSetTexture(0);
+    }
+
+    batch->isDrawing = false;
+}
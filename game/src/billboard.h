@@ -0,0 +1,24 @@
+#ifndef BILLBOARD_H
+#define BILLBOARD_H
+
+#include "raylib.h"
+
+// Camera facing quads written straight into the rlgl render batch. The camera basis is computed
+// once per batch and consecutive quads sharing a texture end up in the same draw call.
+typedef struct BillboardBatch
+{
+	Vector3 right;				// Camera right vector.
+	Vector3 up;
+	unsigned int textureId;		// Texture of the quads currently being added.
+	bool isDrawing;
+
+	int numQuads;				// Statistics for the last batch.
+	int numTextureSwitches;
+
+} BillboardBatch;
+
+void BeginBillboards(BillboardBatch* batch, Camera camera, Vector3 up);
+void AddBillboard(BillboardBatch* batch, Texture2D texture, Rectangle source, Vector3 position, Vector2 size, Color tint);
+void EndBillboards(BillboardBatch* batch);
+
+#endif
@@ -0,0 +1,154 @@
+/**********************************************************************************************
+*
+*   Depth Sort - Frame coherent back-to-front sorting
+*
+*   Depths are computed once per item by the caller (squared camera distance, no sqrt) and
+*   the previous order is re-sorted with insertion sort. When the scene changed too much for
+*   that to be cheap, the sort falls back to a bottom-up merge sort.
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+
+#include "depth_sort.h"
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+#define INSERTION_SORT_SHIFTS_PER_ITEM 8    // Shift budget before falling back to merge sort
+
+//----------------------------------------------------------------------------------
+// Depth Sort Functions Definition
+//----------------------------------------------------------------------------------
+// Returns false if the shift budget ran out, the order is left partially sorted.
+static bool InsertionSortByDepth(int* order, const float* depths, int numItems, int maxShifts)
+{
+    int numShifts = 0;
+
+    for (int i = 1; i < numItems; i++)
+    {
+        int item = order[i];
+        float depth = depths[item];
+        int j = i - 1;
+
+        while (j >= 0 && depths[order[j]] < depth)
+        {
+            order[j + 1] = order[j];
+            j--;
+            numShifts++;
+        }
+
+        order[j + 1] = item;
+
+        if (numShifts > maxShifts)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void MergeSortByDepth(int* order, int* scratch, const float* depths, int numItems)
+{
+    int* source = order;
+    int* target = scratch;
+
+    for (int width = 1; width < numItems; width *= 2)
+    {
+        for (int start = 0; start < numItems; start += width * 2)
+        {
+            int middle = (start + width < numItems) ? start + width : numItems;
+            int end = (start + width * 2 < numItems) ? start + width * 2 : numItems;
+            int left = start;
+            int right = middle;
+
+            for (int i = start; i < end; i++)
+            {
+                if (left < middle && (right >= end || depths[source[left]] >= depths[source[right]]))
+                {
+                    target[i] = source[left];
+                    left++;
+                }
+                else
+                {
+                    target[i] = source[right];
+                    right++;
+                }
+            }
+        }
+
+        int* temp = source;
+        source = target;
+        target = temp;
+    }
+
+    if (source != order)
+    {
+        for (int i = 0; i < numItems; i++)
+        {
+            order[i] = source[i];
+        }
+    }
+}
+
+// Start sorting numItems items, returns the depth array to fill for items 0..numItems-1.
+float* BeginDepthSort(DepthSorter* sorter, int numItems)
+{
+    if (numItems > sorter->maxItems)
+    {
+        sorter->maxItems = (sorter->maxItems == 0) ? 64 : sorter->maxItems;
+        while (sorter->maxItems < numItems) sorter->maxItems *= 2;
+
+        sorter->order = (int*)MemRealloc(sorter->order, sorter->maxItems * sizeof(int));
+        sorter->scratch = (int*)MemRealloc(sorter->scratch, sorter->maxItems * sizeof(int));
+        sorter->depths = (float*)MemRealloc(sorter->depths, sorter->maxItems * sizeof(float));
+    }
+
+    // Keep the previous order for items that still exist, new items go to the end.
+    if (numItems != sorter->numItems)
+    {
+        int numKept = 0;
+
+        for (int i = 0; i < sorter->numItems; i++)
+        {
+            if (sorter->order[i] < numItems)
+            {
+                sorter->order[numKept] = sorter->order[i];
+                numKept++;
+            }
+        }
+
+        for (int item = sorter->numItems; item < numItems; item++)
+        {
+            sorter->order[numKept] = item;
+            numKept++;
+        }
+
+        sorter->numItems = numItems;
+    }
+
+    return sorter->depths;
+}
+
+// Returns item indices ordered by decreasing depth.
+const int* EndDepthSort(DepthSorter* sorter)
+{
+    int maxShifts = sorter->numItems * INSERTION_SORT_SHIFTS_PER_ITEM;
+
+    if (InsertionSortByDepth(sorter->order, sorter->depths, sorter->numItems, maxShifts) == false)
+    {
+        MergeSortByDepth(sorter->order, sorter->scratch, sorter->depths, sorter->numItems);
+    }
+
+    return sorter->order;
+}
+
+void UnloadDepthSorter(DepthSorter* sorter)
+{
+    MemFree(sorter->order);
+    MemFree(sorter->scratch);
+    MemFree(sorter->depths);
+
+    *sorter = (DepthSorter){ 0 };
+}
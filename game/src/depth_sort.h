@@ -0,0 +1,20 @@
+#ifndef DEPTH_SORT_H
+#define DEPTH_SORT_H
+
+// Back-to-front ordering for transparent billboards. The order of the previous frame is kept,
+// so a nearly unchanged scene is re-sorted with a few insertion sort shifts.
+typedef struct DepthSorter
+{
+	int* order;					// Item indices, farthest first.
+	int* scratch;
+	float* depths;				// Sort key per item, filled by the caller.
+	int numItems;
+	int maxItems;
+
+} DepthSorter;
+
+float* BeginDepthSort(DepthSorter* sorter, int numItems);
+const int* EndDepthSort(DepthSorter* sorter);
+void UnloadDepthSorter(DepthSorter* sorter);
+
+#endif
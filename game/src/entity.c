@@ -0,0 +1,122 @@
+/**********************************************************************************************
+*
+*   Entity - Entity storage
+*
+*   Entities are plain ids into parallel arrays. Ids stay valid until the storage is
+*   cleared, dead and removed entities keep their slot.
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+
+#include "entity.h"
+
+#include <string.h>
+
+//----------------------------------------------------------------------------------
+// Entity Functions Definition
+//----------------------------------------------------------------------------------
+static void ReserveEntities(Entities* entities, int maxEntities)
+{
+    if (maxEntities <= entities->maxEntities)
+    {
+        return;
+    }
+
+    entities->positions = (Vector3*)MemRealloc(entities->positions, maxEntities * sizeof(Vector3));
+    entities->tileIndices = (int*)MemRealloc(entities->tileIndices, maxEntities * sizeof(int));
+    entities->teamIDs = (int*)MemRealloc(entities->teamIDs, maxEntities * sizeof(int));
+    entities->types = (unsigned char*)MemRealloc(entities->types, maxEntities * sizeof(unsigned char));
+    entities->flags = (unsigned char*)MemRealloc(entities->flags, maxEntities * sizeof(unsigned char));
+    entities->initiatives = (int*)MemRealloc(entities->initiatives, maxEntities * sizeof(int));
+    entities->healths = (int*)MemRealloc(entities->healths, maxEntities * sizeof(int));
+    entities->maxHealths = (int*)MemRealloc(entities->maxHealths, maxEntities * sizeof(int));
+    entities->infos = (EntityInfo*)MemRealloc(entities->infos, maxEntities * sizeof(EntityInfo));
+
+    entities->maxEntities = maxEntities;
+}
+
+// Add a zeroed entity, returns its id.
+int AddEntity(Entities* entities)
+{
+    if (entities->numEntities == entities->maxEntities)
+    {
+        ReserveEntities(entities, (entities->maxEntities == 0) ? 32 : entities->maxEntities * 2);
+    }
+
+    int entity = entities->numEntities;
+    entities->numEntities++;
+
+    entities->positions[entity] = (Vector3){ 0.0f, 0.0f, 0.0f };
+    entities->tileIndices[entity] = -1;
+    entities->teamIDs[entity] = -1;
+    entities->types[entity] = 0;
+    entities->flags[entity] = 0;
+    entities->initiatives[entity] = 0;
+    entities->healths[entity] = 0;
+    entities->maxHealths[entity] = 0;
+    entities->infos[entity] = (EntityInfo){ 0 };
+
+    return entity;
+}
+
+// Remove all entities, the arrays are kept for reuse.
+void ClearEntities(Entities* entities)
+{
+    entities->numEntities = 0;
+}
+
+// Make destination an exact copy of source, reusing its arrays when they are large enough.
+void CopyEntities(Entities* destination, const Entities* source)
+{
+    int numEntities = source->numEntities;
+
+    destination->numEntities = 0;
+
+    if (numEntities == 0)
+    {
+        return;
+    }
+
+    ReserveEntities(destination, numEntities);
+
+    memcpy(destination->positions, source->positions, numEntities * sizeof(Vector3));
+    memcpy(destination->tileIndices, source->tileIndices, numEntities * sizeof(int));
+    memcpy(destination->teamIDs, source->teamIDs, numEntities * sizeof(int));
+    memcpy(destination->types, source->types, numEntities * sizeof(unsigned char));
+    memcpy(destination->flags, source->flags, numEntities * sizeof(unsigned char));
+    memcpy(destination->initiatives, source->initiatives, numEntities * sizeof(int));
+    memcpy(destination->healths, source->healths, numEntities * sizeof(int));
+    memcpy(destination->maxHealths, source->maxHealths, numEntities * sizeof(int));
+    memcpy(destination->infos, source->infos, numEntities * sizeof(EntityInfo));
+
+    destination->numEntities = numEntities;
+}
+
+void UnloadEntities(Entities* entities)
+{
+    MemFree(entities->positions);
+    MemFree(entities->tileIndices);
+    MemFree(entities->teamIDs);
+    MemFree(entities->types);
+    MemFree(entities->flags);
+    MemFree(entities->initiatives);
+    MemFree(entities->healths);
+    MemFree(entities->maxHealths);
+    MemFree(entities->infos);
+
+    *entities = (Entities){ 0 };
+}
+
+// Box around the sprite standing on the entity's tile, used for picking. Up is negative y.
+BoundingBox GetEntityBoundingBox(Entities* entities, int entity)
+{
+    float boxSize = 1.0f;
+    float boxHeight = entities->infos[entity].size.y;
+
+    Vector3 position = entities->positions[entity];
+    Vector3 boxMin = { position.x, position.y - boxHeight, position.z };
+    Vector3 boxMax = { position.x + boxSize, position.y, position.z + boxSize };
+
+    return (BoundingBox){ boxMin, boxMax };
+}
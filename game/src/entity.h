@@ -3,7 +3,7 @@
 
 #include "raylib.h"
 
-typedef struct Tile Tile;
+#define ENTITY_NONE -1
 
 enum EntityType
 {
@@ -11,33 +11,47 @@ enum EntityType
 	ENTITY_TYPE_TERRAIN_OBJECT
 };
 
-typedef struct Entity
+enum EntityFlag
+{
+	ENTITY_FLAG_ACTIVE = 1,
+	ENTITY_FLAG_ALIVE = 2,
+	ENTITY_FLAG_BLOCKING = 4		// Blocks movement through its tile.
+};
+
+// Sprites of entities, see spriteFileNames in screen_gameplay.c
+typedef enum SpriteID
+{
+	SPRITE_BLANK = 0,
+	SPRITE_TREE,
+	SPRITE_ROCK,
+	SPRITE_ORC,
+	SPRITE_ORC_DEAD,
+	SPRITE_ORC_FACE,
+	SPRITE_WIZARD,
+	SPRITE_WIZARD_DEAD,
+	SPRITE_WIZARD_FACE,
+	SPRITE_KNIGHT,
+	SPRITE_KNIGHT_FACE,
+	SPRITE_MORKO,
+	SPRITE_MORKO_FACE,
+	SPRITE_GOBLIN,
+	SPRITE_UNIT_DEAD,
+	SPRITE_COUNT
+} SpriteID;
+
+// Per entity data that is only needed when the entity is drawn or acts.
+typedef struct EntityInfo
 {
 	// Rendering variables
 
 	Vector2 size;
-	Vector3 position;
-	
-	Texture texture;
-	Texture deathTexture;
-	Rectangle textureRect;
-	BoundingBox boundingBox;
 
-	// Gameplay variables
+	int sprite;					// SpriteID, drawing looks the sprite up from it.
+	int deathSprite;
 
-	Tile* tile;
-	struct Entity* target;
+	// Gameplay variables
 
-	bool isActive;
-	bool isAlive;
-	bool isBlockingMovement;
-	int teamID;
-	int type;
 	int speed;					// How many tiles can the unit move.
-	int baseInitiative;			// Initiative value reset after a finished turn.
-	int currentInitiative;		// Determines position in turn queue.
-	int health;
-	int maxHealth;
 	int minAttack;				// TEMP
 	int maxAttack;
 	char name[256];
@@ -75,7 +89,35 @@ typedef struct Entity
 	int mentalResistance;
 	int elementalResistance;
 	int magicResistance;
-} Entity;
+} EntityInfo;
+
+// Entities in structure of arrays layout. Fields read by per frame and per turn sweeps are
+// kept in packed arrays of their own, everything else lives in infos. All arrays are
+// indexed by entity id.
+typedef struct Entities
+{
+	Vector3* positions;
+	int* tileIndices;			// Map tile index the entity stands on.
+	int* teamIDs;
+	unsigned char* types;
+	unsigned char* flags;		// EntityFlag bits.
+	int* initiatives;			// Time between two turns of the unit, see TurnScheduler.
+	int* healths;
+	int* maxHealths;
+
+	EntityInfo* infos;
+
+	int numEntities;
+	int maxEntities;
+
+} Entities;
+
+int AddEntity(Entities* entities);
+void ClearEntities(Entities* entities);
+void CopyEntities(Entities* destination, const Entities* source);
+void UnloadEntities(Entities* entities);
+
+BoundingBox GetEntityBoundingBox(Entities* entities, int entity);
 
 typedef struct Perk
 {
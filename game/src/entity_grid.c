@@ -0,0 +1,394 @@
+/**********************************************************************************************
+*
+*   Entity Grid - Spatial index of the entities on the map
+*
+*   The map is split into square cells of ENTITY_GRID_CELL_SIZE tiles. Queries only visit
+*   the cells around them, so their cost depends on the entities nearby and not on the
+*   number of entities in the battle. The grid never touches the tiles, queries don't load
+*   map chunks.
+*
+*   Distances are in tiles along the longer axis, the same way units reach their neighbours.
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+
+#include "entity_grid.h"
+
+#include <stdlib.h>
+#include <float.h>
+#include <math.h>
+#include <limits.h>
+
+//----------------------------------------------------------------------------------
+// Entity Grid Functions Definition
+//----------------------------------------------------------------------------------
+static void ReserveGridEntities(EntityGrid* grid, int maxEntities)
+{
+    if (maxEntities <= grid->maxEntities)
+    {
+        return;
+    }
+
+    int newMaxEntities = (grid->maxEntities == 0) ? 64 : grid->maxEntities;
+
+    while (newMaxEntities < maxEntities) newMaxEntities *= 2;
+
+    grid->entityCells = (int*)MemRealloc(grid->entityCells, newMaxEntities * sizeof(int));
+    grid->nextEntities = (int*)MemRealloc(grid->nextEntities, newMaxEntities * sizeof(int));
+    grid->previousEntities = (int*)MemRealloc(grid->previousEntities, newMaxEntities * sizeof(int));
+
+    for (int i = grid->maxEntities; i < newMaxEntities; i++)
+    {
+        grid->entityCells[i] = -1;
+    }
+
+    grid->maxEntities = newMaxEntities;
+}
+
+static int GetTileCell(EntityGrid* grid, int tileIndex)
+{
+    int x = tileIndex % grid->width;
+    int z = tileIndex / grid->width;
+
+    return (z / ENTITY_GRID_CELL_SIZE) * grid->cellsX + (x / ENTITY_GRID_CELL_SIZE);
+}
+
+static int GetGridDistance(EntityGrid* grid, int tileIndex, int entity)
+{
+    int otherIndex = grid->entities->tileIndices[entity];
+    int distanceX = abs(otherIndex % grid->width - tileIndex % grid->width);
+    int distanceZ = abs(otherIndex / grid->width - tileIndex / grid->width);
+
+    return (distanceX > distanceZ) ? distanceX : distanceZ;
+}
+
+static void PushGridResult(EntityGrid* grid, int entity)
+{
+    if (grid->numResults == grid->maxResults)
+    {
+        grid->maxResults = (grid->maxResults == 0) ? 64 : grid->maxResults * 2;
+        grid->results = (int*)MemRealloc(grid->results, grid->maxResults * sizeof(int));
+    }
+
+    grid->results[grid->numResults++] = entity;
+}
+
+void LoadEntityGrid(EntityGrid* grid, Entities* entities, int width, int height)
+{
+    *grid = (EntityGrid){ 0 };
+
+    grid->entities = entities;
+    grid->width = width;
+    grid->height = height;
+    grid->cellsX = (width + ENTITY_GRID_CELL_SIZE - 1) / ENTITY_GRID_CELL_SIZE;
+    grid->cellsZ = (height + ENTITY_GRID_CELL_SIZE - 1) / ENTITY_GRID_CELL_SIZE;
+    grid->cellEntities = (int*)MemAlloc(grid->cellsX * grid->cellsZ * sizeof(int));
+
+    ClearEntityGrid(grid);
+}
+
+void UnloadEntityGrid(EntityGrid* grid)
+{
+    MemFree(grid->cellEntities);
+    MemFree(grid->entityCells);
+    MemFree(grid->nextEntities);
+    MemFree(grid->previousEntities);
+    MemFree(grid->results);
+
+    *grid = (EntityGrid){ 0 };
+}
+
+// Take every entity out of the grid.
+void ClearEntityGrid(EntityGrid* grid)
+{
+    for (int i = 0; i < grid->cellsX * grid->cellsZ; i++)
+    {
+        grid->cellEntities[i] = ENTITY_NONE;
+    }
+
+    for (int i = 0; i < grid->maxEntities; i++)
+    {
+        grid->entityCells[i] = -1;
+    }
+}
+
+// Put the entity in the cell of its tile, adding it to the grid if it isn't in yet.
+void UpdateGridEntity(EntityGrid* grid, int entity)
+{
+    ReserveGridEntities(grid, entity + 1);
+
+    int cell = GetTileCell(grid, grid->entities->tileIndices[entity]);
+
+    if (grid->entityCells[entity] == cell)
+    {
+        return;
+    }
+
+    RemoveGridEntity(grid, entity);
+
+    int next = grid->cellEntities[cell];
+
+    grid->entityCells[entity] = cell;
+    grid->previousEntities[entity] = ENTITY_NONE;
+    grid->nextEntities[entity] = next;
+
+    if (next != ENTITY_NONE) grid->previousEntities[next] = entity;
+
+    grid->cellEntities[cell] = entity;
+}
+
+void RemoveGridEntity(EntityGrid* grid, int entity)
+{
+    if (entity >= grid->maxEntities || grid->entityCells[entity] == -1)
+    {
+        return;
+    }
+
+    int previous = grid->previousEntities[entity];
+    int next = grid->nextEntities[entity];
+
+    if (previous != ENTITY_NONE) grid->nextEntities[previous] = next;
+    else grid->cellEntities[grid->entityCells[entity]] = next;
+
+    if (next != ENTITY_NONE) grid->previousEntities[next] = previous;
+
+    grid->entityCells[entity] = -1;
+}
+
+// Entities within radius tiles of the tile, in no particular order. Returns how many were
+// found, they are in grid->results until the next query.
+int QueryEntityGrid(EntityGrid* grid, int tileIndex, int radius, EntityFilter filter, void* data)
+{
+    int x = tileIndex % grid->width;
+    int z = tileIndex / grid->width;
+    int minCellX = (x - radius < 0) ? 0 : (x - radius) / ENTITY_GRID_CELL_SIZE;
+    int minCellZ = (z - radius < 0) ? 0 : (z - radius) / ENTITY_GRID_CELL_SIZE;
+    int maxCellX = (x + radius) / ENTITY_GRID_CELL_SIZE;
+    int maxCellZ = (z + radius) / ENTITY_GRID_CELL_SIZE;
+
+    if (maxCellX >= grid->cellsX) maxCellX = grid->cellsX - 1;
+    if (maxCellZ >= grid->cellsZ) maxCellZ = grid->cellsZ - 1;
+
+    grid->numResults = 0;
+
+    for (int cellZ = minCellZ; cellZ <= maxCellZ; cellZ++)
+    {
+        for (int cellX = minCellX; cellX <= maxCellX; cellX++)
+        {
+            int entity = grid->cellEntities[cellZ * grid->cellsX + cellX];
+
+            for (; entity != ENTITY_NONE; entity = grid->nextEntities[entity])
+            {
+                if (GetGridDistance(grid, tileIndex, entity) <= radius && (filter == NULL || filter(data, entity)))
+                {
+                    PushGridResult(grid, entity);
+                }
+            }
+        }
+    }
+
+    return grid->numResults;
+}
+
+// Up to count entities closest to the tile, sorted by distance and then by id, so the result
+// doesn't depend on the order entities were moved in. Returns how many were found.
+int FindClosestGridEntities(EntityGrid* grid, int tileIndex, int count, EntityFilter filter, void* data, int* closest)
+{
+    int x = tileIndex % grid->width;
+    int z = tileIndex / grid->width;
+    int centerX = x / ENTITY_GRID_CELL_SIZE;
+    int centerZ = z / ENTITY_GRID_CELL_SIZE;
+    int maxRing = (grid->cellsX > grid->cellsZ) ? grid->cellsX : grid->cellsZ;
+    int numClosest = 0;
+    int lastDistance = INT_MAX;
+
+    if (count <= 0)
+    {
+        return 0;
+    }
+
+    // Cells in rings around the tile's cell. Every tile of the next ring is more than
+    // ring * ENTITY_GRID_CELL_SIZE tiles away, so the search ends once the closest found are
+    // nearer than that.
+    for (int ring = 0; ring <= maxRing; ring++)
+    {
+        for (int cellZ = centerZ - ring; cellZ <= centerZ + ring; cellZ++)
+        {
+            if (cellZ < 0 || cellZ >= grid->cellsZ)
+            {
+                continue;
+            }
+
+            bool isEdgeRow = (cellZ == centerZ - ring || cellZ == centerZ + ring);
+            int stepX = (isEdgeRow || ring == 0) ? 1 : 2 * ring;
+
+            for (int cellX = centerX - ring; cellX <= centerX + ring; cellX += stepX)
+            {
+                if (cellX < 0 || cellX >= grid->cellsX)
+                {
+                    continue;
+                }
+
+                int entity = grid->cellEntities[cellZ * grid->cellsX + cellX];
+
+                for (; entity != ENTITY_NONE; entity = grid->nextEntities[entity])
+                {
+                    if (filter != NULL && filter(data, entity) == false)
+                    {
+                        continue;
+                    }
+
+                    int distance = GetGridDistance(grid, tileIndex, entity);
+
+                    if (numClosest == count && (lastDistance < distance || (lastDistance == distance && closest[count - 1] < entity)))
+                    {
+                        continue;
+                    }
+
+                    int index = (numClosest < count) ? numClosest++ : count - 1;
+
+                    while (index > 0)
+                    {
+                        int other = closest[index - 1];
+                        int otherDistance = GetGridDistance(grid, tileIndex, other);
+
+                        if (otherDistance < distance || (otherDistance == distance && other < entity))
+                        {
+                            break;
+                        }
+
+                        closest[index] = other;
+                        index--;
+                    }
+
+                    closest[index] = entity;
+                    lastDistance = GetGridDistance(grid, tileIndex, closest[numClosest - 1]);
+                }
+            }
+        }
+
+        if (numClosest == count && lastDistance <= ring * ENTITY_GRID_CELL_SIZE)
+        {
+            break;
+        }
+    }
+
+    return numClosest;
+}
+
+// Closest entity whose bounding box the ray hits, or ENTITY_NONE. Walks the cells under the
+// ray in order (Amanatides & Woo grid traversal), entities stand on their tile at any height.
+int GetGridRayCollision(EntityGrid* grid, Ray ray, EntityFilter filter, void* data, RayCollision* collision)
+{
+    *collision = (RayCollision){ 0 };
+
+    // Clip the ray to the map area, tiles are one unit wide.
+    float origins[2] = { ray.position.x, ray.position.z };
+    float directions[2] = { ray.direction.x, ray.direction.z };
+    float sizes[2] = { (float)grid->width, (float)grid->height };
+    float enter = 0.0f;
+    float leave = FLT_MAX;
+
+    for (int i = 0; i < 2; i++)
+    {
+        if (directions[i] == 0.0f)
+        {
+            if (origins[i] < 0.0f || origins[i] > sizes[i]) return ENTITY_NONE;
+            continue;
+        }
+
+        float nearDistance = (0.0f - origins[i]) / directions[i];
+        float farDistance = (sizes[i] - origins[i]) / directions[i];
+
+        if (nearDistance > farDistance)
+        {
+            float temp = nearDistance;
+            nearDistance = farDistance;
+            farDistance = temp;
+        }
+
+        if (nearDistance > enter) enter = nearDistance;
+        if (farDistance < leave) leave = farDistance;
+    }
+
+    if (enter > leave)
+    {
+        return ENTITY_NONE;
+    }
+
+    float cellSize = (float)ENTITY_GRID_CELL_SIZE;
+    int cellX = (int)floorf((ray.position.x + ray.direction.x * enter) / cellSize);
+    int cellZ = (int)floorf((ray.position.z + ray.direction.z * enter) / cellSize);
+
+    if (cellX >= grid->cellsX) cellX = grid->cellsX - 1;
+    if (cellZ >= grid->cellsZ) cellZ = grid->cellsZ - 1;
+    if (cellX < 0) cellX = 0;
+    if (cellZ < 0) cellZ = 0;
+
+    int stepX = (ray.direction.x > 0.0f) ? 1 : -1;
+    int stepZ = (ray.direction.z > 0.0f) ? 1 : -1;
+    float nextX = FLT_MAX;
+    float nextZ = FLT_MAX;
+    float deltaX = FLT_MAX;
+    float deltaZ = FLT_MAX;
+
+    if (ray.direction.x != 0.0f)
+    {
+        nextX = ((float)(cellX + ((stepX > 0) ? 1 : 0)) * cellSize - ray.position.x) / ray.direction.x;
+        deltaX = cellSize / fabsf(ray.direction.x);
+    }
+
+    if (ray.direction.z != 0.0f)
+    {
+        nextZ = ((float)(cellZ + ((stepZ > 0) ? 1 : 0)) * cellSize - ray.position.z) / ray.direction.z;
+        deltaZ = cellSize / fabsf(ray.direction.z);
+    }
+
+    while (cellX >= 0 && cellZ >= 0 && cellX < grid->cellsX && cellZ < grid->cellsZ)
+    {
+        int hitEntity = ENTITY_NONE;
+        int entity = grid->cellEntities[cellZ * grid->cellsX + cellX];
+
+        for (; entity != ENTITY_NONE; entity = grid->nextEntities[entity])
+        {
+            if (filter != NULL && filter(data, entity) == false)
+            {
+                continue;
+            }
+
+            RayCollision entityCollision = GetRayCollisionBox(ray, GetEntityBoundingBox(grid->entities, entity));
+
+            if (entityCollision.hit && (hitEntity == ENTITY_NONE || entityCollision.distance < collision->distance))
+            {
+                hitEntity = entity;
+                *collision = entityCollision;
+            }
+        }
+
+        // Boxes stay within the tile of their entity, a hit in this cell is closer than
+        // anything in the cells after it.
+        if (hitEntity != ENTITY_NONE)
+        {
+            return hitEntity;
+        }
+
+        if (nextX > leave && nextZ > leave)
+        {
+            break;
+        }
+
+        if (nextX < nextZ)
+        {
+            cellX += stepX;
+            nextX += deltaX;
+        }
+        else
+        {
+            cellZ += stepZ;
+            nextZ += deltaZ;
+        }
+    }
+
+    return ENTITY_NONE;
+}
@@ -0,0 +1,46 @@
+#ifndef ENTITY_GRID_H
+#define ENTITY_GRID_H
+
+#include "raylib.h"
+#include "entity.h"
+
+#define ENTITY_GRID_CELL_SIZE 8		// Cell width in tiles.
+
+// Picks the entities a query returns, NULL keeps them all.
+typedef bool (*EntityFilter)(void* data, int entity);
+
+// Uniform grid over the map that keeps every entity in the cell of its tile, so range and
+// ray queries only look at the entities around them. The entities of a cell are a linked
+// list through arrays indexed by entity id, moving an entity is a few writes.
+typedef struct EntityGrid
+{
+	Entities* entities;			// Cells follow tileIndices, update the grid whenever it changes.
+	int width;					// Map size in tiles.
+	int height;
+	int cellsX;
+	int cellsZ;
+
+	int* cellEntities;			// First entity of every cell, ENTITY_NONE if empty.
+	int* entityCells;			// Cell of every entity, -1 if it is not in the grid.
+	int* nextEntities;			// Entities before and after in the same cell.
+	int* previousEntities;
+	int maxEntities;
+
+	int* results;				// Result of the last QueryEntityGrid() call.
+	int numResults;
+	int maxResults;
+
+} EntityGrid;
+
+void LoadEntityGrid(EntityGrid* grid, Entities* entities, int width, int height);
+void UnloadEntityGrid(EntityGrid* grid);
+void ClearEntityGrid(EntityGrid* grid);
+
+void UpdateGridEntity(EntityGrid* grid, int entity);
+void RemoveGridEntity(EntityGrid* grid, int entity);
+
+int QueryEntityGrid(EntityGrid* grid, int tileIndex, int radius, EntityFilter filter, void* data);
+int FindClosestGridEntities(EntityGrid* grid, int tileIndex, int count, EntityFilter filter, void* data, int* closest);
+int GetGridRayCollision(EntityGrid* grid, Ray ray, EntityFilter filter, void* data, RayCollision* collision);
+
+#endif
@@ -0,0 +1,640 @@
+/**********************************************************************************************
+*
+*   Level - Chunked tile map
+*
+*   The map is split into CHUNK_SIZE x CHUNK_SIZE tile chunks. Chunk headers exist for the
+*   whole map, tile memory only for loaded chunks. The terrain is derived from the map seed
+*   and tile coordinates, so an evicted chunk is generated identically when loaded again.
+*
+*   Elevation is a few octaves of value noise, a second noise field adds moisture. Together
+*   they pick the biome of every tile. Noise is evaluated a row of samples at a time, one
+*   lattice lookup per noise cell and a plain blend loop per sample that compilers vectorize.
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+
+#include "level.h"
+#include "entity.h"
+#include "rng.h"
+
+#include <stdlib.h>
+#include <math.h>
+#include <float.h>
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+#define TILE_SIZE 1
+#define TERRAIN_HEIGHT 1.5f         // Vertex height of the highest elevation, up is negative y.
+#define MAX_VERTEX_HEIGHT TERRAIN_HEIGHT    // Vertex heights stay within -MAX_VERTEX_HEIGHT and MAX_VERTEX_HEIGHT.
+#define TERRAIN_OCTAVES 4
+#define TERRAIN_WAVELENGTH 24.0f    // Tiles between the noise lattice points of the first octave.
+#define MOISTURE_OCTAVES 2
+#define MOISTURE_WAVELENGTH 16.0f
+#define NOISE_MAX_CELLS (CHUNK_SIZE + 3)    // Noise cells along a chunk row, wavelengths are at least one tile.
+
+#define SEA_LEVEL -0.35f            // Elevations go from -1 to 1, below this the terrain is flat water.
+#define SHORE_LEVEL -0.28f
+#define ROCK_LEVEL 0.35f
+#define FOREST_MOISTURE 0.15f       // Moisture goes from -1 to 1 as well.
+
+#define CHUNK_KEEP_RADIUS 1         // Chunks around the focus tile that are never evicted.
+
+typedef struct BiomeInfo
+{
+    bool walkable;
+    unsigned char moveCost;
+
+} BiomeInfo;
+
+static const BiomeInfo biomeInfos[BIOME_COUNT] = {
+    [BIOME_WATER] = { false, 1 },
+    [BIOME_SAND] = { true, 2 },
+    [BIOME_GRASS] = { true, 1 },
+    [BIOME_FOREST] = { true, 2 },
+    [BIOME_ROCK] = { true, 2 },
+};
+
+// Chunks generated by one LoadMapChunks() call.
+typedef struct MapChunkTasks
+{
+    Map* map;
+    MapChunk** chunks;
+
+} MapChunkTasks;
+
+//----------------------------------------------------------------------------------
+// Level Functions Definition
+//----------------------------------------------------------------------------------
+// Noise value of a lattice point, from -1 to 1.
+static float GetLatticeValue(uint64_t seed, int stream, int x, int z)
+{
+    uint32_t hash = GetRngHash(seed, (uint64_t)stream, ((uint64_t)(uint32_t)z << 32) | (uint32_t)x);
+
+    return (float)hash / 2147483647.5f - 1.0f;
+}
+
+// Add one octave of smoothed value noise to count samples along the row, starting at vertex
+// (x, z). Vertex coordinates are never negative, truncating rounds down.
+static void AddNoiseRow(float* samples, int count, int x, int z, float wavelength, float amplitude, uint64_t seed, int stream)
+{
+    float frequency = 1.0f / wavelength;
+    float cellZ = (float)z * frequency;
+    int latticeZ = (int)cellZ;
+    float blendZ = cellZ - (float)latticeZ;
+    int firstCell = (int)((float)x * frequency);
+    int numCells = (int)((float)(x + count - 1) * frequency) - firstCell + 2;
+    float columns[NOISE_MAX_CELLS] = { 0 };
+
+    blendZ = blendZ * blendZ * (3.0f - 2.0f * blendZ);
+
+    // Blend the lattice rows above and below once per cell, not per sample.
+    for (int i = 0; i < numCells; i++)
+    {
+        float bottom = GetLatticeValue(seed, stream, firstCell + i, latticeZ);
+        float top = GetLatticeValue(seed, stream, firstCell + i, latticeZ + 1);
+
+        columns[i] = bottom + (top - bottom) * blendZ;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        float cellX = (float)(x + i) * frequency;
+        int cell = (int)cellX;
+        float blendX = cellX - (float)cell;
+
+        blendX = blendX * blendX * (3.0f - 2.0f * blendX);
+        cell -= firstCell;
+
+        samples[i] += amplitude * (columns[cell] + (columns[cell + 1] - columns[cell]) * blendX);
+    }
+}
+
+// Fractal noise from -1 to 1, every octave has half the wavelength and amplitude of the last.
+static void GetNoiseRow(Map* map, float* samples, int count, int x, int z, int stream, int numOctaves, float wavelength)
+{
+    float amplitude = 1.0f;
+    float totalAmplitude = 0.0f;
+
+    for (int i = 0; i < count; i++)
+    {
+        samples[i] = 0.0f;
+    }
+
+    for (int octave = 0; octave < numOctaves; octave++)
+    {
+        AddNoiseRow(samples, count, x, z, wavelength, amplitude, ((uint64_t)octave << 32) | map->seed, stream);
+
+        totalAmplitude += amplitude;
+        amplitude *= 0.5f;
+        wavelength *= 0.5f;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        samples[i] /= totalAmplitude;
+    }
+}
+
+static void GetElevationRow(Map* map, float* elevations, int count, int x, int z)
+{
+    GetNoiseRow(map, elevations, count, x, z, RNG_STREAM_TERRAIN, TERRAIN_OCTAVES, TERRAIN_WAVELENGTH);
+}
+
+// Water is flat at sea level, whatever the ground below it does.
+static float GetElevationHeight(float elevation)
+{
+    return -((elevation > SEA_LEVEL) ? elevation : SEA_LEVEL) * TERRAIN_HEIGHT;
+}
+
+static int GetTileBiome(float elevation, float moisture)
+{
+    if (elevation < SEA_LEVEL) return BIOME_WATER;
+    if (elevation < SHORE_LEVEL) return BIOME_SAND;
+    if (elevation > ROCK_LEVEL) return BIOME_ROCK;
+    if (moisture > FOREST_MOISTURE) return BIOME_FOREST;
+
+    return BIOME_GRASS;
+}
+
+// Fill the chunk tiles. Only touches the chunk itself, chunks can be generated in parallel.
+static void GenerateMapChunk(Map* map, MapChunk* chunk)
+{
+    float elevations[(CHUNK_SIZE + 1) * (CHUNK_SIZE + 1)] = { 0 };
+    float moistures[CHUNK_SIZE] = { 0 };
+    int vertexWidth = chunk->width + 1;
+    int firstX = chunk->chunkX * CHUNK_SIZE;
+    int firstZ = chunk->chunkZ * CHUNK_SIZE;
+
+    for (int localZ = 0; localZ <= chunk->height; localZ++)
+    {
+        GetElevationRow(map, &elevations[localZ * vertexWidth], vertexWidth, firstX, firstZ + localZ);
+    }
+
+    for (int localZ = 0; localZ < chunk->height; localZ++)
+    {
+        GetNoiseRow(map, moistures, chunk->width, firstX, firstZ + localZ, RNG_STREAM_MOISTURE, MOISTURE_OCTAVES, MOISTURE_WAVELENGTH);
+
+        for (int localX = 0; localX < chunk->width; localX++)
+        {
+            Tile* tile = &chunk->tiles[localZ * CHUNK_SIZE + localX];
+            int x = firstX + localX;
+            int z = firstZ + localZ;
+
+            float bottomLeftElevation = elevations[localZ * vertexWidth + localX];
+            float bottomRightElevation = elevations[localZ * vertexWidth + localX + 1];
+            float topRightElevation = elevations[(localZ + 1) * vertexWidth + localX + 1];
+            float topLeftElevation = elevations[(localZ + 1) * vertexWidth + localX];
+
+            float bottomLeftHeight = GetElevationHeight(bottomLeftElevation);
+            float bottomRightHeight = GetElevationHeight(bottomRightElevation);
+            float topRightHeight = GetElevationHeight(topRightElevation);
+            float topLeftHeight = GetElevationHeight(topLeftElevation);
+
+            *tile = (Tile){ 0 };
+            tile->x = x;
+            tile->z = z;
+
+            tile->bottomLeft = (Vector3){ (float)x, bottomLeftHeight, (float)z };
+            tile->bottomRight = (Vector3){ (float)x + TILE_SIZE, bottomRightHeight, (float)z };
+            tile->topRight = (Vector3){ (float)x + TILE_SIZE, topRightHeight, (float)z + TILE_SIZE };
+            tile->topLeft = (Vector3){ (float)x, topLeftHeight, (float)z + TILE_SIZE };
+
+            tile->tileCenterPos.x = (tile->bottomLeft.x + tile->topRight.x) / 2;
+            tile->tileCenterPos.y = (tile->bottomLeft.z + tile->topRight.z) / 2;
+
+            tile->entityPos = (bottomLeftHeight + bottomRightHeight + topRightHeight + topLeftHeight) / 4;
+            tile->entity = ENTITY_NONE;
+            tile->biome = (unsigned char)GetTileBiome((bottomLeftElevation + bottomRightElevation + topRightElevation + topLeftElevation) / 4, moistures[localX]);
+            tile->walkable = biomeInfos[tile->biome].walkable;
+            tile->moveCost = biomeInfos[tile->biome].moveCost;
+            tile->selectionMark = 0;
+        }
+    }
+
+    chunk->numEntities = 0;
+    chunk->revision++;
+}
+
+static void RunMapChunkTask(void* data, int taskIndex, int workerIndex)
+{
+    (void)workerIndex;
+
+    MapChunkTasks* tasks = (MapChunkTasks*)data;
+
+    GenerateMapChunk(tasks->map, tasks->chunks[taskIndex]);
+}
+
+static bool IsMapChunkEvictable(Map* map, MapChunk* chunk, int focusChunkX, int focusChunkZ)
+{
+    if (chunk->tiles == NULL || chunk->lastUsed == map->frame)
+    {
+        return false;
+    }
+
+    if (abs(chunk->chunkX - focusChunkX) <= CHUNK_KEEP_RADIUS && abs(chunk->chunkZ - focusChunkZ) <= CHUNK_KEEP_RADIUS)
+    {
+        return false;
+    }
+
+    // Regenerating the chunk would lose the entities standing on it.
+    return chunk->numEntities == 0;
+}
+
+bool LoadMap(Map* map, int width, int height, int maxLoadedChunks, unsigned int seed)
+{
+    *map = (Map){ 0 };
+
+    if (width <= 0 || height <= 0)
+    {
+        TraceLog(LOG_WARNING, "MAP: Invalid map size %dx%d", width, height);
+        return false;
+    }
+
+    map->width = width;
+    map->height = height;
+    map->chunksX = (width + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    map->chunksZ = (height + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    map->maxLoadedChunks = maxLoadedChunks;
+    map->selectionMark = 1;
+    map->seed = seed;
+
+    map->chunks = (MapChunk*)MemAlloc(map->chunksX * map->chunksZ * sizeof(MapChunk));
+
+    for (int chunkZ = 0; chunkZ < map->chunksZ; chunkZ++)
+    {
+        for (int chunkX = 0; chunkX < map->chunksX; chunkX++)
+        {
+            MapChunk* chunk = &map->chunks[chunkZ * map->chunksX + chunkX];
+
+            chunk->chunkX = chunkX;
+            chunk->chunkZ = chunkZ;
+            chunk->width = (chunkX == map->chunksX - 1) ? width - chunkX * CHUNK_SIZE : CHUNK_SIZE;
+            chunk->height = (chunkZ == map->chunksZ - 1) ? height - chunkZ * CHUNK_SIZE : CHUNK_SIZE;
+        }
+    }
+
+    TraceLog(LOG_INFO, "MAP: Created %dx%d map in %dx%d chunks", width, height, map->chunksX, map->chunksZ);
+
+    return true;
+}
+
+void UnloadMap(Map* map)
+{
+    for (int i = 0; i < map->chunksX * map->chunksZ; i++)
+    {
+        MemFree(map->chunks[i].tiles);
+    }
+
+    MemFree(map->chunks);
+    *map = (Map){ 0 };
+}
+
+// Returns the chunk with its tiles loaded, or NULL when outside the map.
+MapChunk* GetMapChunk(Map* map, int chunkX, int chunkZ)
+{
+    if (chunkX < 0 || chunkZ < 0 || chunkX >= map->chunksX || chunkZ >= map->chunksZ)
+    {
+        return NULL;
+    }
+
+    MapChunk* chunk = &map->chunks[chunkZ * map->chunksX + chunkX];
+
+    if (chunk->tiles == NULL)
+    {
+        chunk->tiles = (Tile*)MemAlloc(CHUNK_TILES * sizeof(Tile));
+        map->numLoadedChunks++;
+
+        GenerateMapChunk(map, chunk);
+    }
+
+    chunk->lastUsed = map->frame;
+
+    return chunk;
+}
+
+// Load every chunk in the rectangle of chunk coordinates, both corners included. Missing
+// chunks are generated in parallel on the pool, or on this thread when it is NULL. They count
+// against the memory budget like chunks loaded on access.
+void LoadMapChunks(Map* map, ThreadPool* pool, int minChunkX, int minChunkZ, int maxChunkX, int maxChunkZ)
+{
+    if (minChunkX < 0) minChunkX = 0;
+    if (minChunkZ < 0) minChunkZ = 0;
+    if (maxChunkX >= map->chunksX) maxChunkX = map->chunksX - 1;
+    if (maxChunkZ >= map->chunksZ) maxChunkZ = map->chunksZ - 1;
+
+    if (minChunkX > maxChunkX || minChunkZ > maxChunkZ)
+    {
+        return;
+    }
+
+    MapChunkTasks tasks = { map, (MapChunk**)MemAlloc((maxChunkX - minChunkX + 1) * (maxChunkZ - minChunkZ + 1) * sizeof(MapChunk*)) };
+    int numChunks = 0;
+
+    for (int chunkZ = minChunkZ; chunkZ <= maxChunkZ; chunkZ++)
+    {
+        for (int chunkX = minChunkX; chunkX <= maxChunkX; chunkX++)
+        {
+            MapChunk* chunk = &map->chunks[chunkZ * map->chunksX + chunkX];
+
+            if (chunk->tiles == NULL)
+            {
+                chunk->tiles = (Tile*)MemAlloc(CHUNK_TILES * sizeof(Tile));
+                map->numLoadedChunks++;
+                tasks.chunks[numChunks++] = chunk;
+            }
+
+            chunk->lastUsed = map->frame;
+        }
+    }
+
+    if (pool != NULL)
+    {
+        RunParallelFor(pool, numChunks, RunMapChunkTask, &tasks);
+    }
+    else
+    {
+        for (int i = 0; i < numChunks; i++) GenerateMapChunk(map, tasks.chunks[i]);
+    }
+
+    MemFree(tasks.chunks);
+}
+
+// Returns the tile at given map coordinates, or NULL when outside the map.
+Tile* GetMapTile(Map* map, int x, int z)
+{
+    if (x < 0 || z < 0 || x >= map->width || z >= map->height)
+    {
+        return NULL;
+    }
+
+    MapChunk* chunk = GetMapChunk(map, x / CHUNK_SIZE, z / CHUNK_SIZE);
+
+    return &chunk->tiles[(z % CHUNK_SIZE) * CHUNK_SIZE + (x % CHUNK_SIZE)];
+}
+
+// Tile indices are row-major over the whole map: z * width + x.
+Tile* GetMapTileByIndex(Map* map, int tileIndex)
+{
+    if (tileIndex < 0 || tileIndex >= map->width * map->height)
+    {
+        return NULL;
+    }
+
+    return GetMapTile(map, tileIndex % map->width, tileIndex / map->width);
+}
+
+int GetMapTileIndex(Map* map, Tile* tile)
+{
+    return tile->z * map->width + tile->x;
+}
+
+// Where an entity standing on the tile is placed.
+Vector3 GetTileEntityPosition(Tile* tile)
+{
+    return (Vector3){ tile->bottomLeft.x, tile->entityPos, tile->bottomLeft.z };
+}
+
+// Put the entity on the tile, ENTITY_NONE empties it. Always go through here, the chunks
+// count their entities so eviction doesn't have to look at every tile.
+void SetTileEntity(Map* map, Tile* tile, int entity)
+{
+    MapChunk* chunk = &map->chunks[(tile->z / CHUNK_SIZE) * map->chunksX + tile->x / CHUNK_SIZE];
+
+    if (tile->entity != ENTITY_NONE) chunk->numEntities--;
+    if (entity != ENTITY_NONE) chunk->numEntities++;
+
+    tile->entity = entity;
+}
+
+// Empty every loaded tile, the chunks become evictable again.
+void ClearMapEntities(Map* map)
+{
+    for (int i = 0; i < map->chunksX * map->chunksZ; i++)
+    {
+        MapChunk* chunk = &map->chunks[i];
+
+        if (chunk->tiles == NULL)
+        {
+            continue;
+        }
+
+        for (int j = 0; j < CHUNK_TILES; j++)
+        {
+            chunk->tiles[j].entity = ENTITY_NONE;
+        }
+
+        chunk->numEntities = 0;
+    }
+}
+
+float GetMapVertexHeight(Map* map, int x, int z)
+{
+    float elevation = 0.0f;
+
+    GetElevationRow(map, &elevation, 1, x, z);
+
+    return GetElevationHeight(elevation);
+}
+
+// Entry and exit distances of the ray through the box the terrain fits in.
+static bool ClipRayToMap(Map* map, Ray ray, float* enter, float* leave)
+{
+    float origins[3] = { ray.position.x, ray.position.y, ray.position.z };
+    float directions[3] = { ray.direction.x, ray.direction.y, ray.direction.z };
+    float boxMin[3] = { 0.0f, -MAX_VERTEX_HEIGHT, 0.0f };
+    float boxMax[3] = { (float)map->width * TILE_SIZE, MAX_VERTEX_HEIGHT, (float)map->height * TILE_SIZE };
+
+    *enter = 0.0f;
+    *leave = FLT_MAX;
+
+    for (int i = 0; i < 3; i++)
+    {
+        if (directions[i] == 0.0f)
+        {
+            if (origins[i] < boxMin[i] || origins[i] > boxMax[i]) return false;
+            continue;
+        }
+
+        float nearDistance = (boxMin[i] - origins[i]) / directions[i];
+        float farDistance = (boxMax[i] - origins[i]) / directions[i];
+
+        if (nearDistance > farDistance)
+        {
+            float temp = nearDistance;
+            nearDistance = farDistance;
+            farDistance = temp;
+        }
+
+        if (nearDistance > *enter) *enter = nearDistance;
+        if (farDistance < *leave) *leave = farDistance;
+    }
+
+    return *enter <= *leave;
+}
+
+// The two triangles of the tile, split the same way as the terrain mesh.
+static RayCollision GetTileRayCollision(Tile* tile, Ray ray)
+{
+    RayCollision collision = GetRayCollisionTriangle(ray, tile->topLeft, tile->bottomLeft, tile->bottomRight);
+    RayCollision other = GetRayCollisionTriangle(ray, tile->topLeft, tile->bottomRight, tile->topRight);
+
+    if (other.hit && (collision.hit == false || other.distance < collision.distance))
+    {
+        collision = other;
+    }
+
+    return collision;
+}
+
+// Closest tile hit by the ray, or NULL. Walks the tiles under the ray in order (Amanatides &
+// Woo grid traversal) and tests only those, within the height range of the terrain. The cost
+// depends on the tiles crossed, not on the map size.
+Tile* GetMapRayCollision(Map* map, Ray ray, RayCollision* collision)
+{
+    float enter = 0.0f;
+    float leave = 0.0f;
+
+    *collision = (RayCollision){ 0 };
+
+    if (ClipRayToMap(map, ray, &enter, &leave) == false)
+    {
+        return NULL;
+    }
+
+    float startX = (ray.position.x + ray.direction.x * enter) / TILE_SIZE;
+    float startZ = (ray.position.z + ray.direction.z * enter) / TILE_SIZE;
+
+    // Entering through the far edge of the box rounds up to a tile outside the map.
+    int x = (int)floorf(startX);
+    int z = (int)floorf(startZ);
+
+    if (x >= map->width) x = map->width - 1;
+    if (z >= map->height) z = map->height - 1;
+    if (x < 0) x = 0;
+    if (z < 0) z = 0;
+
+    int stepX = (ray.direction.x > 0.0f) ? 1 : -1;
+    int stepZ = (ray.direction.z > 0.0f) ? 1 : -1;
+
+    // Ray distance to the next tile edge on each axis, and between two edges.
+    float nextX = FLT_MAX;
+    float nextZ = FLT_MAX;
+    float deltaX = FLT_MAX;
+    float deltaZ = FLT_MAX;
+
+    if (ray.direction.x != 0.0f)
+    {
+        nextX = ((float)(x + ((stepX > 0) ? 1 : 0)) * TILE_SIZE - ray.position.x) / ray.direction.x;
+        deltaX = TILE_SIZE / fabsf(ray.direction.x);
+    }
+
+    if (ray.direction.z != 0.0f)
+    {
+        nextZ = ((float)(z + ((stepZ > 0) ? 1 : 0)) * TILE_SIZE - ray.position.z) / ray.direction.z;
+        deltaZ = TILE_SIZE / fabsf(ray.direction.z);
+    }
+
+    while (x >= 0 && z >= 0 && x < map->width && z < map->height)
+    {
+        Tile* tile = GetMapTile(map, x, z);
+        RayCollision tileCollision = GetTileRayCollision(tile, ray);
+
+        // Tiles come in order along the ray, the first one hit is the closest.
+        if (tileCollision.hit)
+        {
+            *collision = tileCollision;
+            return tile;
+        }
+
+        if (nextX > leave && nextZ > leave)
+        {
+            break;
+        }
+
+        if (nextX < nextZ)
+        {
+            x += stepX;
+            nextX += deltaX;
+        }
+        else
+        {
+            z += stepZ;
+            nextZ += deltaZ;
+        }
+    }
+
+    return NULL;
+}
+
+// Free least recently used chunks until the map is back within its memory budget.
+// Tile pointers stay valid for the whole frame, eviction only happens here, and chunks
+// holding entities or surrounding the focus tile are always kept.
+void EvictMapChunks(Map* map, int focusX, int focusZ)
+{
+    int focusChunkX = focusX / CHUNK_SIZE;
+    int focusChunkZ = focusZ / CHUNK_SIZE;
+
+    while (map->numLoadedChunks > map->maxLoadedChunks)
+    {
+        MapChunk* oldestChunk = NULL;
+
+        for (int i = 0; i < map->chunksX * map->chunksZ; i++)
+        {
+            MapChunk* chunk = &map->chunks[i];
+
+            if (IsMapChunkEvictable(map, chunk, focusChunkX, focusChunkZ) && (oldestChunk == NULL || chunk->lastUsed < oldestChunk->lastUsed))
+            {
+                oldestChunk = chunk;
+            }
+        }
+
+        if (oldestChunk == NULL)
+        {
+            break;
+        }
+
+        MemFree(oldestChunk->tiles);
+        oldestChunk->tiles = NULL;
+        oldestChunk->revision++;
+        map->numLoadedChunks--;
+    }
+
+    map->frame++;
+}
+
+// Deselect all tiles in O(1), tiles only count as selected while their mark matches.
+void ClearTileSelection(Map* map)
+{
+    map->selectionMark++;
+
+    // Mark wrapped around, stale marks could match again.
+    if (map->selectionMark == 0)
+    {
+        for (int i = 0; i < map->chunksX * map->chunksZ; i++)
+        {
+            if (map->chunks[i].tiles == NULL)
+            {
+                continue;
+            }
+
+            for (int j = 0; j < CHUNK_TILES; j++)
+            {
+                map->chunks[i].tiles[j].selectionMark = 0;
+            }
+        }
+
+        map->selectionMark = 1;
+    }
+}
+
+void SelectTile(Map* map, Tile* tile)
+{
+    tile->selectionMark = map->selectionMark;
+}
+
+bool IsTileSelected(Map* map, Tile* tile)
+{
+    return tile->selectionMark == map->selectionMark;
+}
@@ -2,8 +2,19 @@
 #define LEVEL_H
 
 #include "raylib.h"
+#include "thread_pool.h"
 
-typedef struct Entity Entity;
+// Terrain types, the biome of a tile decides its colour, whether units can walk on it and
+// what entering it costs.
+enum TileBiome
+{
+	BIOME_WATER,
+	BIOME_SAND,
+	BIOME_GRASS,
+	BIOME_FOREST,
+	BIOME_ROCK,
+	BIOME_COUNT
+};
 
 typedef struct Tile
 {
@@ -12,24 +23,86 @@ typedef struct Tile
 	Vector3 topLeft;
 	Vector3 topRight;
 	Vector2 tileCenterPos;
+	int x;						// Tile coordinates in the whole map.
+	int z;
 
-	Texture texture;
 	float entityPos;
 
 	// Gameplay variables
 
-	Entity* entity;
+	int entity;					// Id of the entity on the tile, ENTITY_NONE if empty.
 	bool walkable;
+	unsigned char biome;		// TileBiome
+	unsigned char moveCost;		// Movement points spent to enter the tile, at least 1.
+	unsigned int selectionMark;	// Tile is selected while this matches the map selection mark.
 
 } Tile;
 
+#define SPAWN_ZONE_MAX_TILES 128
+
 typedef struct SpawnZone
 {
-	Tile* tiles[128];
+	int tiles[SPAWN_ZONE_MAX_TILES];	// Map tile indices, the chunks of the tiles can be evicted.
 	
 	int playerID;
 	int numTiles;
 
 } SpawnZone;
 
+// Maps are stored in fixed size chunks that are generated on first access and can be
+// evicted again, so only the area around the action has to be kept in memory.
+#define CHUNK_SIZE 32
+#define CHUNK_TILES (CHUNK_SIZE * CHUNK_SIZE)
+
+typedef struct MapChunk
+{
+	Tile* tiles;				// CHUNK_TILES tiles, NULL while the chunk is not loaded.
+
+	int chunkX;
+	int chunkZ;
+	int width;					// Chunks on the right and top edge of the map can be smaller.
+	int height;
+	int numEntities;			// Tiles holding an entity, chunks with entities are never evicted.
+
+	unsigned int lastUsed;		// Map frame of the last access, oldest chunks are evicted first.
+	unsigned int revision;		// Bumped when the chunk is loaded or evicted, renderers rebuild on mismatch.
+
+} MapChunk;
+
+typedef struct Map
+{
+	MapChunk* chunks;
+
+	int width;					// Map size in tiles.
+	int height;
+	int chunksX;				// Map size in chunks.
+	int chunksZ;
+
+	int numLoadedChunks;
+	int maxLoadedChunks;		// Memory budget, chunks holding entities may exceed this.
+	unsigned int frame;
+	unsigned int selectionMark;
+	unsigned int seed;
+
+} Map;
+
+bool LoadMap(Map* map, int width, int height, int maxLoadedChunks, unsigned int seed);
+void UnloadMap(Map* map);
+
+MapChunk* GetMapChunk(Map* map, int chunkX, int chunkZ);
+void LoadMapChunks(Map* map, ThreadPool* pool, int minChunkX, int minChunkZ, int maxChunkX, int maxChunkZ);
+Tile* GetMapTile(Map* map, int x, int z);
+Tile* GetMapTileByIndex(Map* map, int tileIndex);
+int GetMapTileIndex(Map* map, Tile* tile);
+Vector3 GetTileEntityPosition(Tile* tile);
+void SetTileEntity(Map* map, Tile* tile, int entity);
+void ClearMapEntities(Map* map);
+float GetMapVertexHeight(Map* map, int x, int z);
+Tile* GetMapRayCollision(Map* map, Ray ray, RayCollision* collision);
+void EvictMapChunks(Map* map, int focusX, int focusZ);
+
+void ClearTileSelection(Map* map);
+void SelectTile(Map* map, Tile* tile);
+bool IsTileSelected(Map* map, Tile* tile);
+
 #endif
\ No newline at end of file
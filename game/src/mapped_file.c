@@ -0,0 +1,100 @@
+/**********************************************************************************************
+*
+*   Mapped File - Read only memory mapped files
+*
+*   mmap() on POSIX systems, file mapping objects on Windows. Empty files can't be mapped
+*   and fail to open.
+*
+**********************************************************************************************/
+
+#include "mapped_file.h"
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+//----------------------------------------------------------------------------------
+// Mapped File Functions Definition
+//----------------------------------------------------------------------------------
+bool OpenMappedFile(MappedFile* file, const char* fileName)
+{
+    *file = (MappedFile){ 0 };
+
+#if defined(_WIN32)
+    HANDLE fileHandle = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if (fileHandle == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize = { 0 };
+    HANDLE mapping = NULL;
+
+    if (GetFileSizeEx(fileHandle, &fileSize) && fileSize.QuadPart > 0)
+    {
+        mapping = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+    }
+
+    // The view keeps the file open, the handles are not needed after mapping it.
+    if (mapping != NULL)
+    {
+        file->data = (const unsigned char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        file->size = (size_t)fileSize.QuadPart;
+
+        CloseHandle(mapping);
+    }
+
+    CloseHandle(fileHandle);
+#else
+    int fd = open(fileName, O_RDONLY);
+
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat fileStat;
+
+    if (fstat(fd, &fileStat) == 0 && fileStat.st_size > 0)
+    {
+        void* data = mmap(NULL, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (data != MAP_FAILED)
+        {
+            file->data = (const unsigned char*)data;
+            file->size = (size_t)fileStat.st_size;
+        }
+    }
+
+    close(fd);
+#endif
+
+    if (file->data == NULL)
+    {
+        file->size = 0;
+        return false;
+    }
+
+    return true;
+}
+
+void CloseMappedFile(MappedFile* file)
+{
+    if (file->data != NULL)
+    {
+#if defined(_WIN32)
+        UnmapViewOfFile(file->data);
+#else
+        munmap((void*)file->data, file->size);
+#endif
+    }
+
+    *file = (MappedFile){ 0 };
+}
@@ -0,0 +1,20 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+// Read only view of a whole file mapped to memory. Pages are read in by the OS on first
+// access instead of copied through a buffer. Like the thread pool this doesn't include
+// raylib.h, so windows.h can't collide with it.
+typedef struct MappedFile
+{
+	const unsigned char* data;
+	size_t size;
+
+} MappedFile;
+
+bool OpenMappedFile(MappedFile* file, const char* fileName);
+void CloseMappedFile(MappedFile* file);
+
+#endif
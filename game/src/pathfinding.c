@@ -0,0 +1,445 @@
+/**********************************************************************************************
+*
+*   Pathfinding - Grid searches over the tile map
+*
+*   Movement is 4-connected, entering a tile costs its move cost. Searches only touch the
+*   tiles they visit, nothing scales with the map size.
+*
+*   Both searches share a binary heap open set. FindReachableTiles() is Dijkstra's algorithm,
+*   FindPath() is an A* search with the Manhattan distance as heuristic, which never
+*   overestimates since every tile costs at least one. Results are kept in a small cache keyed
+*   by goal tile until ClearPathCache(), so hovering the same tiles again during a turn doesn't
+*   search again.
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+
+#include "pathfinding.h"
+
+#include <stdlib.h>
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+#define PATH_CACHE_MAX_TILES 65536     // Cache tile buffer is reset when growing past this
+
+static const int neighbourOffsets[4][2] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 } };
+
+//----------------------------------------------------------------------------------
+// Pathfinding Functions Definition
+//----------------------------------------------------------------------------------
+static PathNode* GetPathNodeAt(Pathfinder* pathfinder, int x, int z)
+{
+    Map* map = pathfinder->map;
+    int chunkIndex = (z / CHUNK_SIZE) * map->chunksX + (x / CHUNK_SIZE);
+
+    if (pathfinder->chunkNodes[chunkIndex] == NULL)
+    {
+        pathfinder->chunkNodes[chunkIndex] = (PathNode*)MemAlloc(CHUNK_TILES * sizeof(PathNode));
+        pathfinder->nodeChunks[pathfinder->numNodeChunks++] = chunkIndex;
+    }
+
+    return &pathfinder->chunkNodes[chunkIndex][(z % CHUNK_SIZE) * CHUNK_SIZE + (x % CHUNK_SIZE)];
+}
+
+static PathNode* GetPathNode(Pathfinder* pathfinder, Tile* tile)
+{
+    return GetPathNodeAt(pathfinder, tile->x, tile->z);
+}
+
+// Free the node blocks of evicted chunks, or of all chunks.
+static void ReleasePathNodes(Pathfinder* pathfinder, bool releaseAll)
+{
+    int numKept = 0;
+
+    for (int i = 0; i < pathfinder->numNodeChunks; i++)
+    {
+        int chunkIndex = pathfinder->nodeChunks[i];
+
+        if (releaseAll || pathfinder->map->chunks[chunkIndex].tiles == NULL)
+        {
+            MemFree(pathfinder->chunkNodes[chunkIndex]);
+            pathfinder->chunkNodes[chunkIndex] = NULL;
+        }
+        else
+        {
+            pathfinder->nodeChunks[numKept++] = chunkIndex;
+        }
+    }
+
+    pathfinder->numNodeChunks = numKept;
+}
+
+// Invalidate all nodes of the previous search.
+static void BeginSearch(Pathfinder* pathfinder)
+{
+    pathfinder->mark++;
+
+    // Mark wrapped around, old nodes could look visited again.
+    if (pathfinder->mark == 0)
+    {
+        ReleasePathNodes(pathfinder, true);
+        pathfinder->mark = 1;
+    }
+    else
+    {
+        ReleasePathNodes(pathfinder, false);
+    }
+}
+
+static bool IsPathNodeBefore(PathNode* a, PathNode* b)
+{
+    // Prefer the deeper node on ties, it is closer to the goal.
+    return (a->estimate < b->estimate) || (a->estimate == b->estimate && a->cost > b->cost);
+}
+
+static void SwapHeapNodes(Pathfinder* pathfinder, int a, int b)
+{
+    PathNode* temp = pathfinder->heap[a];
+    pathfinder->heap[a] = pathfinder->heap[b];
+    pathfinder->heap[b] = temp;
+
+    pathfinder->heap[a]->heapIndex = a;
+    pathfinder->heap[b]->heapIndex = b;
+}
+
+static void SiftHeapUp(Pathfinder* pathfinder, int index)
+{
+    while (index > 0)
+    {
+        int parent = (index - 1) / 2;
+
+        if (IsPathNodeBefore(pathfinder->heap[index], pathfinder->heap[parent]) == false)
+        {
+            break;
+        }
+
+        SwapHeapNodes(pathfinder, index, parent);
+        index = parent;
+    }
+}
+
+static void PushHeap(Pathfinder* pathfinder, PathNode* node)
+{
+    if (pathfinder->heapSize == pathfinder->maxHeap)
+    {
+        pathfinder->maxHeap = (pathfinder->maxHeap == 0) ? 256 : pathfinder->maxHeap * 2;
+        pathfinder->heap = (PathNode**)MemRealloc(pathfinder->heap, pathfinder->maxHeap * sizeof(PathNode*));
+    }
+
+    node->heapIndex = pathfinder->heapSize;
+    pathfinder->heap[pathfinder->heapSize] = node;
+    pathfinder->heapSize++;
+
+    SiftHeapUp(pathfinder, node->heapIndex);
+}
+
+static PathNode* PopHeap(Pathfinder* pathfinder)
+{
+    PathNode* top = pathfinder->heap[0];
+
+    pathfinder->heapSize--;
+    pathfinder->heap[0] = pathfinder->heap[pathfinder->heapSize];
+    pathfinder->heap[0]->heapIndex = 0;
+
+    int index = 0;
+
+    while (true)
+    {
+        int left = index * 2 + 1;
+        int right = left + 1;
+        int smallest = index;
+
+        if (left < pathfinder->heapSize && IsPathNodeBefore(pathfinder->heap[left], pathfinder->heap[smallest])) smallest = left;
+        if (right < pathfinder->heapSize && IsPathNodeBefore(pathfinder->heap[right], pathfinder->heap[smallest])) smallest = right;
+
+        if (smallest == index)
+        {
+            break;
+        }
+
+        SwapHeapNodes(pathfinder, index, smallest);
+        index = smallest;
+    }
+
+    top->heapIndex = -1;
+
+    return top;
+}
+
+static int GetPathHeuristic(Tile* tile, Tile* goal)
+{
+    return abs(tile->x - goal->x) + abs(tile->z - goal->z);
+}
+
+static PathCacheEntry* GetPathCacheEntry(Pathfinder* pathfinder, int goalIndex)
+{
+    unsigned int hash = (unsigned int)goalIndex * 2654435761u;
+
+    return &pathfinder->cache[(hash >> 24) % PATH_CACHE_SIZE];
+}
+
+// Walk the parents back from the goal node and store the path in the cache tile buffer.
+static void StorePath(Pathfinder* pathfinder, PathCacheEntry* entry, PathNode* goalNode)
+{
+    Map* map = pathfinder->map;
+    PathNode* node = goalNode;
+
+    entry->numTiles = 1;
+    entry->cost = goalNode->cost;
+
+    while (node->parent != -1)
+    {
+        node = GetPathNodeAt(pathfinder, node->parent % map->width, node->parent / map->width);
+        entry->numTiles++;
+    }
+
+    if (pathfinder->numCacheTiles + entry->numTiles > PATH_CACHE_MAX_TILES)
+    {
+        ClearPathCache(pathfinder);
+        entry->isUsed = true;
+    }
+
+    if (pathfinder->numCacheTiles + entry->numTiles > pathfinder->maxCacheTiles)
+    {
+        while (pathfinder->numCacheTiles + entry->numTiles > pathfinder->maxCacheTiles)
+        {
+            pathfinder->maxCacheTiles = (pathfinder->maxCacheTiles == 0) ? 256 : pathfinder->maxCacheTiles * 2;
+        }
+
+        pathfinder->cacheTiles = (int*)MemRealloc(pathfinder->cacheTiles, pathfinder->maxCacheTiles * sizeof(int));
+    }
+
+    entry->offset = pathfinder->numCacheTiles;
+    pathfinder->numCacheTiles += entry->numTiles;
+
+    node = goalNode;
+
+    for (int i = entry->numTiles - 1; i >= 0; i--)
+    {
+        pathfinder->cacheTiles[entry->offset + i] = node->tileIndex;
+
+        if (node->parent != -1)
+        {
+            node = GetPathNodeAt(pathfinder, node->parent % map->width, node->parent / map->width);
+        }
+    }
+}
+
+static void AddReachableTile(Pathfinder* pathfinder, Tile* tile)
+{
+    if (pathfinder->numReachableTiles == pathfinder->maxReachableTiles)
+    {
+        pathfinder->maxReachableTiles = (pathfinder->maxReachableTiles == 0) ? 64 : pathfinder->maxReachableTiles * 2;
+        pathfinder->reachableTiles = (Tile**)MemRealloc(pathfinder->reachableTiles, pathfinder->maxReachableTiles * sizeof(Tile*));
+    }
+
+    pathfinder->reachableTiles[pathfinder->numReachableTiles] = tile;
+    pathfinder->numReachableTiles++;
+}
+
+void LoadPathfinder(Pathfinder* pathfinder, Map* map, Entities* entities)
+{
+    *pathfinder = (Pathfinder){ 0 };
+    pathfinder->map = map;
+    pathfinder->entities = entities;
+    pathfinder->chunkNodes = (PathNode**)MemAlloc(map->chunksX * map->chunksZ * sizeof(PathNode*));
+    pathfinder->nodeChunks = (int*)MemAlloc(map->chunksX * map->chunksZ * sizeof(int));
+}
+
+void UnloadPathfinder(Pathfinder* pathfinder)
+{
+    ReleasePathNodes(pathfinder, true);
+
+    MemFree(pathfinder->chunkNodes);
+    MemFree(pathfinder->nodeChunks);
+    MemFree(pathfinder->heap);
+    MemFree(pathfinder->cacheTiles);
+    MemFree(pathfinder->reachableTiles);
+
+    *pathfinder = (Pathfinder){ 0 };
+}
+
+// Can a unit walk through the tile?
+bool IsTilePassable(Entities* entities, Tile* tile)
+{
+    return tile->walkable && (tile->entity == ENTITY_NONE || (entities->flags[tile->entity] & ENTITY_FLAG_BLOCKING) == 0);
+}
+
+// Cheapest first flood fill from the start tile, up to range movement points. Results are
+// stored in reachableTiles, the start tile included, in order of increasing cost.
+int FindReachableTiles(Pathfinder* pathfinder, Tile* start, int range)
+{
+    Map* map = pathfinder->map;
+
+    BeginSearch(pathfinder);
+    pathfinder->heapSize = 0;
+    pathfinder->numReachableTiles = 0;
+
+    PathNode* startNode = GetPathNode(pathfinder, start);
+    startNode->mark = pathfinder->mark;
+    startNode->cost = 0;
+    startNode->parent = -1;
+    startNode->tileIndex = GetMapTileIndex(map, start);
+    startNode->estimate = 0;
+
+    PushHeap(pathfinder, startNode);
+
+    while (pathfinder->heapSize > 0)
+    {
+        PathNode* node = PopHeap(pathfinder);
+        Tile* tile = GetMapTileByIndex(map, node->tileIndex);
+
+        AddReachableTile(pathfinder, tile);
+
+        for (int i = 0; i < 4; i++)
+        {
+            Tile* neighbour = GetMapTile(map, tile->x + neighbourOffsets[i][0], tile->z + neighbourOffsets[i][1]);
+
+            if (neighbour == NULL || IsTilePassable(pathfinder->entities, neighbour) == false)
+            {
+                continue;
+            }
+
+            PathNode* neighbourNode = GetPathNode(pathfinder, neighbour);
+            int cost = node->cost + neighbour->moveCost;
+
+            if (cost > range)
+            {
+                continue;
+            }
+
+            if (neighbourNode->mark != pathfinder->mark)
+            {
+                neighbourNode->mark = pathfinder->mark;
+                neighbourNode->cost = cost;
+                neighbourNode->parent = node->tileIndex;
+                neighbourNode->tileIndex = GetMapTileIndex(map, neighbour);
+                neighbourNode->estimate = cost;
+
+                PushHeap(pathfinder, neighbourNode);
+            }
+            else if (neighbourNode->heapIndex >= 0 && cost < neighbourNode->cost)
+            {
+                neighbourNode->cost = cost;
+                neighbourNode->estimate = cost;
+                neighbourNode->parent = node->tileIndex;
+
+                SiftHeapUp(pathfinder, neighbourNode->heapIndex);
+            }
+        }
+    }
+
+    return pathfinder->numReachableTiles;
+}
+
+// Shortest path from start to goal over passable tiles. Paths costing more than maxCost are
+// not searched, pass -1 for no limit. Results stay cached until ClearPathCache().
+Path FindPath(Pathfinder* pathfinder, Tile* start, Tile* goal, int maxCost)
+{
+    Map* map = pathfinder->map;
+    int startIndex = GetMapTileIndex(map, start);
+    int goalIndex = GetMapTileIndex(map, goal);
+
+    PathCacheEntry* entry = GetPathCacheEntry(pathfinder, goalIndex);
+
+    if (entry->isUsed == false || entry->start != startIndex || entry->goal != goalIndex || entry->maxCost != maxCost)
+    {
+        *entry = (PathCacheEntry){ 0 };
+        entry->isUsed = true;
+        entry->start = startIndex;
+        entry->goal = goalIndex;
+        entry->maxCost = maxCost;
+
+        if (start == goal || IsTilePassable(pathfinder->entities, goal))
+        {
+            BeginSearch(pathfinder);
+            pathfinder->heapSize = 0;
+
+            PathNode* startNode = GetPathNode(pathfinder, start);
+            startNode->mark = pathfinder->mark;
+            startNode->cost = 0;
+            startNode->parent = -1;
+            startNode->tileIndex = startIndex;
+            startNode->estimate = GetPathHeuristic(start, goal);
+
+            PushHeap(pathfinder, startNode);
+
+            while (pathfinder->heapSize > 0)
+            {
+                PathNode* node = PopHeap(pathfinder);
+
+                if (node->tileIndex == goalIndex)
+                {
+                    StorePath(pathfinder, entry, node);
+                    entry->isFound = true;
+                    break;
+                }
+
+                int x = node->tileIndex % map->width;
+                int z = node->tileIndex / map->width;
+
+                for (int i = 0; i < 4; i++)
+                {
+                    Tile* neighbour = GetMapTile(map, x + neighbourOffsets[i][0], z + neighbourOffsets[i][1]);
+
+                    if (neighbour == NULL || IsTilePassable(pathfinder->entities, neighbour) == false)
+                    {
+                        continue;
+                    }
+
+                    PathNode* neighbourNode = GetPathNode(pathfinder, neighbour);
+                    int cost = node->cost + neighbour->moveCost;
+
+                    if (maxCost >= 0 && cost > maxCost)
+                    {
+                        continue;
+                    }
+
+                    if (neighbourNode->mark != pathfinder->mark)
+                    {
+                        neighbourNode->mark = pathfinder->mark;
+                        neighbourNode->cost = cost;
+                        neighbourNode->parent = node->tileIndex;
+                        neighbourNode->tileIndex = GetMapTileIndex(map, neighbour);
+                        neighbourNode->estimate = cost + GetPathHeuristic(neighbour, goal);
+
+                        PushHeap(pathfinder, neighbourNode);
+                    }
+                    else if (neighbourNode->heapIndex >= 0 && cost < neighbourNode->cost)
+                    {
+                        neighbourNode->estimate -= neighbourNode->cost - cost;
+                        neighbourNode->cost = cost;
+                        neighbourNode->parent = node->tileIndex;
+
+                        SiftHeapUp(pathfinder, neighbourNode->heapIndex);
+                    }
+                }
+            }
+        }
+    }
+
+    Path path = { 0 };
+    path.isFound = entry->isFound;
+
+    if (entry->isFound)
+    {
+        path.tileIndices = &pathfinder->cacheTiles[entry->offset];
+        path.numTiles = entry->numTiles;
+        path.cost = entry->cost;
+    }
+
+    return path;
+}
+
+// Forget cached paths, call whenever units move or the active unit changes.
+void ClearPathCache(Pathfinder* pathfinder)
+{
+    for (int i = 0; i < PATH_CACHE_SIZE; i++)
+    {
+        pathfinder->cache[i].isUsed = false;
+    }
+
+    pathfinder->numCacheTiles = 0;
+}
@@ -0,0 +1,85 @@
+#ifndef PATHFINDING_H
+#define PATHFINDING_H
+
+#include "raylib.h"
+#include "level.h"
+#include "entity.h"
+
+// Search data of one tile. Nodes are only valid while their mark matches the pathfinder mark,
+// so starting a new search never has to clear anything.
+typedef struct PathNode
+{
+	unsigned int mark;
+	int cost;					// Movement cost from the search start tile.
+	int parent;					// Map tile index of the previous tile on the path, -1 at the start.
+
+	int tileIndex;
+	int estimate;				// A* cost plus heuristic to the goal.
+	int heapIndex;				// Position in the open set, -1 once closed.
+
+} PathNode;
+
+// Tiles from start to goal, both included. Points into the path cache, valid until the
+// cache is cleared or the next FindPath() call.
+typedef struct Path
+{
+	const int* tileIndices;
+	int numTiles;
+	int cost;
+	bool isFound;
+
+} Path;
+
+#define PATH_CACHE_SIZE 256
+
+typedef struct PathCacheEntry
+{
+	int start;
+	int goal;
+	int maxCost;
+	int offset;					// First tile in the path cache tile buffer.
+	int numTiles;
+	int cost;
+	bool isFound;
+	bool isUsed;
+
+} PathCacheEntry;
+
+// Reusable grid search context for one map. Node blocks are allocated per map chunk on first
+// visit and kept for later searches until the chunk is evicted, the search cost only depends
+// on the area visited.
+typedef struct Pathfinder
+{
+	Map* map;
+	Entities* entities;			// Blocking entities stop the search.
+	PathNode** chunkNodes;
+	int* nodeChunks;			// Indices of the chunks that have a node block.
+	int numNodeChunks;
+
+	PathNode** heap;			// Open set of both searches, binary min-heap on estimate.
+	int heapSize;
+	int maxHeap;
+
+	PathCacheEntry cache[PATH_CACHE_SIZE];
+	int* cacheTiles;
+	int numCacheTiles;
+	int maxCacheTiles;
+
+	Tile** reachableTiles;		// Result of the last FindReachableTiles() call.
+	int numReachableTiles;
+	int maxReachableTiles;
+
+	unsigned int mark;
+
+} Pathfinder;
+
+void LoadPathfinder(Pathfinder* pathfinder, Map* map, Entities* entities);
+void UnloadPathfinder(Pathfinder* pathfinder);
+
+bool IsTilePassable(Entities* entities, Tile* tile);
+int FindReachableTiles(Pathfinder* pathfinder, Tile* start, int range);
+
+Path FindPath(Pathfinder* pathfinder, Tile* start, Tile* goal, int maxCost);
+void ClearPathCache(Pathfinder* pathfinder);
+
+#endif
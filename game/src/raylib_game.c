@@ -24,18 +24,9 @@
 // NOTE: Those variables are shared between modules through screens.h
 //----------------------------------------------------------------------------------
 GameScreen currentScreen = LOGO;
-Font font = { 0 };
-Music music = { 0 };
-Sound fxCoin = { 0 };
-Texture2D grassTexture = { 0 };
-Texture2D treeTexture = { 0 };
-Texture2D rockTexture = { 0 };
-Texture2D orcTexture = { 0 };
-Texture2D deadOrcTexture = { 0 };
-Texture2D wizardTexture = { 0 };
-Texture2D deadWizardTexture = { 0 };
-Texture2D blankTexture = { 0 };
+AssetManager* assets = NULL;
 Camera3D camera = { 0 };
+float updateAlpha = 0.0f;
 
 //----------------------------------------------------------------------------------
 // Local Variables Definition (local to this module)
@@ -43,6 +34,18 @@ Camera3D camera = { 0 };
 static const int screenWidth = 1920;
 static const int screenHeight = 1080;
 
+// Assets loaded behind the logo screen, so they are ready when the screens ask for them by name
+static AssetHandle fontAsset = ASSET_NONE;
+static AssetHandle fxCoinAsset = ASSET_NONE;
+static AssetHandle grassTextureAsset = ASSET_NONE;
+static AssetHandle musicAsset = ASSET_NONE;             // NOTE: Music keeps playing between screens
+
+#define MAX_FRAME_TIME 0.25f    // Longer frames are cut short, the game slows down instead of stalling to catch up.
+
+// Game time runs in fixed updates, whatever the frame rate
+static float updateAccumulator = 0.0f;
+static bool isVsyncEnabled = true;      // Otherwise frames are drawn as fast as possible
+
 // Required variables to manage screen transitions (fade-in, fade-out)
 static float transAlpha = 0.0f;
 static bool onTransition = false;
@@ -54,11 +57,14 @@ static GameScreen transToScreen = UNKNOWN;
 // Local Functions Declaration
 //----------------------------------------------------------------------------------
 static void ChangeToScreen(int screen);     // Change to screen, no transition effect
+static void FinishLoading(void);            // Drop the references of the assets loaded at startup
 
 static void TransitionToScreen(int screen); // Request transition to next screen
 static void UpdateTransition(void);         // Update transition effect
 static void DrawTransition(void);           // Draw transition effect (full-screen rectangle)
 
+static void SetVsync(bool enabled);         // Switch between vsync and uncapped frame rate
+static void FixedUpdate(void);              // Advance game time by one fixed update
 static void UpdateDrawFrame(void);          // Update and draw one frame
 
 //----------------------------------------------------------------------------------
@@ -68,23 +74,25 @@ int main(void)
 {
     // Initialization
     //---------------------------------------------------------
+    if (isVsyncEnabled) SetConfigFlags(FLAG_VSYNC_HINT);
+
     InitWindow(screenWidth, screenHeight, "raylib game template");
     SetTraceLogLevel(LOG_DEBUG);
 
     InitAudioDevice();      // Initialize audio device
 
     // Load global data (assets that must be available in all screens, i.e. font)
-    font = LoadFont("resources/mecha.png");
-    music = LoadMusicStream("resources/ambient.ogg");
-    fxCoin = LoadSound("resources/coin.wav");
-    grassTexture = LoadTexture("resources/grass.png");
-    treeTexture = LoadTexture("resources/tree.png");
-    rockTexture = LoadTexture("resources/rock.png");
-    orcTexture = LoadTexture("resources/orc.png");
-    deadOrcTexture = LoadTexture("resources/orc_dead.png");
-    wizardTexture = LoadTexture("resources/wizard.png");
-    deadWizardTexture = LoadTexture("resources/wizard_dead.png");
-    blankTexture = LoadTexture("resources/blank.png");
+    // NOTE: Files are decoded on worker threads while the logo screen shows the progress
+    assets = LoadAssetManager(0);
+
+#if defined(DEBUG)
+    SetAssetHotReload(assets, true);    // Edited resources show up without a restart
+#endif
+
+    fontAsset = LoadAsset(assets, ASSET_FONT, FONT_FILE_NAME);
+    fxCoinAsset = LoadAsset(assets, ASSET_SOUND, COIN_SOUND_FILE_NAME);
+    grassTextureAsset = LoadAsset(assets, ASSET_TEXTURE, GRASS_TEXTURE_FILE_NAME);
+    musicAsset = LoadAsset(assets, ASSET_MUSIC, MUSIC_FILE_NAME);
 
     camera.position = (Vector3){ 0.0f, 0.0f, 10.0f };       // Camera position
     camera.target = (Vector3){ 0.0f };         // Camera target it looks-at
@@ -92,17 +100,14 @@ int main(void)
     camera.fovy = 60;             // Camera field-of-view aperture in Y (degrees) in perspective, used as near plane width in orthographic
     camera.projection = CAMERA_PERSPECTIVE;         // Camera projection: CAMERA_PERSPECTIVE or CAMERA_ORTHOGRAPHIC
 
-    SetMusicVolume(music, 1.0f);
-    // PlayMusicStream(music);
-
     // Setup and init first screen
-    currentScreen = GAMEPLAY;
-    InitGameplayScreen();
+    currentScreen = LOGO;
+    InitLogoScreen();
 
 #if defined(PLATFORM_WEB)
-    emscripten_set_main_loop(UpdateDrawFrame, 60, 1);
+    emscripten_set_main_loop(UpdateDrawFrame, 0, 1);    // Browser refresh rate, game time is fixed anyway
 #else
-    SetTargetFPS(60);       // Set our game to run at 60 frames-per-second
+    SetVsync(isVsyncEnabled);
     //--------------------------------------------------------------------------------------
 
     // Main game loop
@@ -125,17 +130,7 @@ int main(void)
     }
 
     // Unload global data loaded
-    UnloadFont(font);
-    UnloadMusicStream(music);
-    UnloadSound(fxCoin);
-    UnloadTexture(grassTexture);
-    UnloadTexture(treeTexture);
-    UnloadTexture(rockTexture);
-    UnloadTexture(orcTexture);
-    UnloadTexture(deadOrcTexture);
-    UnloadTexture(wizardTexture);
-    UnloadTexture(deadWizardTexture);
-    UnloadTexture(blankTexture);
+    UnloadAssetManager(assets);     // Frees every loaded asset, referenced or not
 
     CloseAudioDevice();     // Close audio context
 
@@ -174,6 +169,18 @@ static void ChangeToScreen(GameScreen screen)
     currentScreen = screen;
 }
 
+// The screens hold references of their own, the startup ones are dropped. The assets stay
+// loaded until the memory budget needs the space.
+static void FinishLoading(void)
+{
+    UnloadAsset(assets, fontAsset);
+    UnloadAsset(assets, fxCoinAsset);
+    UnloadAsset(assets, grassTextureAsset);
+
+    SetMusicVolume(GetAssetMusic(assets, musicAsset), 1.0f);
+    // PlayMusicStream(GetAssetMusic(assets, musicAsset));
+}
+
 // Request transition to next screen
 static void TransitionToScreen(GameScreen screen)
 {
@@ -239,6 +246,38 @@ static void UpdateTransition(void)
     }
 }
 
+// Vsync caps frames to the display refresh rate, without it frames are not capped at all
+static void SetVsync(bool enabled)
+{
+    isVsyncEnabled = enabled;
+
+    if (enabled) SetWindowState(FLAG_VSYNC_HINT);
+    else ClearWindowState(FLAG_VSYNC_HINT);
+
+    SetTargetFPS(0);
+
+    TraceLog(LOG_INFO, "GAME: Frame rate %s", enabled ? "vsync" : "uncapped");
+}
+
+// Everything that advances with game time: transitions, animations and the battle. Input is
+// read once per frame in UpdateDrawFrame(), a fixed update may run several times or not at all
+// during one frame and would miss or repeat key presses.
+static void FixedUpdate(void)
+{
+    if (onTransition)
+    {
+        UpdateTransition();
+        return;
+    }
+
+    switch (currentScreen)
+    {
+        case LOGO: UpdateLogoScreen(); break;
+        case GAMEPLAY: FixedUpdateGameplayScreen(); break;
+        default: break;
+    }
+}
+
 // Draw transition effect (full-screen rectangle)
 static void DrawTransition(void)
 {
@@ -248,9 +287,28 @@ static void DrawTransition(void)
 // Update and draw game frame
 static void UpdateDrawFrame(void)
 {
+    // Uploads of the assets decoded since the last frame
+    UpdateAssetManager(assets);
+
+    // Fixed updates
+    //----------------------------------------------------------------------------------
+    updateAccumulator += (GetFrameTime() < MAX_FRAME_TIME) ? GetFrameTime() : MAX_FRAME_TIME;
+
+    while (updateAccumulator >= FIXED_TIME_STEP)
+    {
+        FixedUpdate();
+        updateAccumulator -= FIXED_TIME_STEP;
+    }
+
+    // Frames between two updates draw moving things part way between their last two positions
+    updateAlpha = updateAccumulator / FIXED_TIME_STEP;
+    //----------------------------------------------------------------------------------
+
     // Update
     //----------------------------------------------------------------------------------
-    // UpdateMusicStream(music);       // NOTE: Music keeps playing between screens
+    // UpdateMusicStream(GetAssetMusic(assets, musicAsset));
+
+    if (IsKeyPressed(KEY_F1)) SetVsync(!isVsyncEnabled);
 
     if (!onTransition)
     {
@@ -258,9 +316,11 @@ static void UpdateDrawFrame(void)
         {
             case LOGO:
             {
-                UpdateLogoScreen();
-
-                if (FinishLogoScreen()) TransitionToScreen(TITLE);
+                if (FinishLogoScreen())
+                {
+                    FinishLoading();
+                    TransitionToScreen(GAMEPLAY);
+                }
 
             } break;
             case TITLE:
@@ -296,7 +356,6 @@ static void UpdateDrawFrame(void)
             default: break;
         }
     }
-    else UpdateTransition();    // Update transition (fade-in, fade-out)
     //----------------------------------------------------------------------------------
 
     // Draw
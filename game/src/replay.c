@@ -0,0 +1,470 @@
+/**********************************************************************************************
+*
+*   Replay - Battle command logs
+*
+*   A battle is fully decided by its seed and the commands given to it, so a replay stores
+*   only those: the spawns, the start of the battle and one record per action. Everything
+*   else is re-simulated on playback. Little-endian binary, an action is 10 bytes.
+*
+*   Header: "HRPL", u16 version, u16 reserved, u32 seed, i32 width, i32 height
+*   Object: u8 type, u16 x, u16 z
+*   Character: u8 type, u8 team, u16 speed, u16 initiative, u16 health, u16 max health,
+*       u16 min attack, u16 max attack, u8 name length, name
+*   Begin: u8 type
+*   Action: u8 type, u8 action type, u16 entity, u32 tile index, u16 target (0xffff if none)
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+
+#include "replay.h"
+
+#include <string.h>
+#include <limits.h>
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+#define REPLAY_HEADER_SIZE 20
+#define REPLAY_MAX_RECORD_SIZE (16 + REPLAY_MAX_NAME)
+#define REPLAY_MAX_LOADED_CHUNKS 64
+#define REPLAY_NO_TARGET 0xffff
+
+static const unsigned char replayMagic[4] = { 'H', 'R', 'P', 'L' };
+
+//----------------------------------------------------------------------------------
+// Encoding Functions Definition
+//----------------------------------------------------------------------------------
+static unsigned char* PutU16(unsigned char* data, unsigned int value)
+{
+    data[0] = (unsigned char)(value & 0xff);
+    data[1] = (unsigned char)((value >> 8) & 0xff);
+
+    return data + 2;
+}
+
+static unsigned char* PutU32(unsigned char* data, unsigned int value)
+{
+    data = PutU16(data, value & 0xffff);
+
+    return PutU16(data, (value >> 16) & 0xffff);
+}
+
+static unsigned int GetU16(const unsigned char* data)
+{
+    return (unsigned int)data[0] | ((unsigned int)data[1] << 8);
+}
+
+static unsigned int GetU32(const unsigned char* data)
+{
+    return GetU16(data) | (GetU16(data + 2) << 16);
+}
+
+//----------------------------------------------------------------------------------
+// Replay Writer Functions Definition
+//----------------------------------------------------------------------------------
+static void WriteReplayRecord(ReplayWriter* writer, const unsigned char* data, int size)
+{
+    if (writer->file == NULL)
+    {
+        return;
+    }
+
+    if (fwrite(data, 1, size, writer->file) != (size_t)size)
+    {
+        TraceLog(LOG_WARNING, "REPLAY: Failed to write record, recording stopped");
+
+        CloseReplayWriter(writer);
+        return;
+    }
+
+    writer->numRecords++;
+}
+
+bool OpenReplayWriter(ReplayWriter* writer, const char* fileName, unsigned int seed, int width, int height)
+{
+    *writer = (ReplayWriter){ 0 };
+
+    writer->file = fopen(fileName, "wb");
+
+    if (writer->file == NULL)
+    {
+        TraceLog(LOG_WARNING, "REPLAY: [%s] Failed to open file for writing", fileName);
+        return false;
+    }
+
+    unsigned char header[REPLAY_HEADER_SIZE];
+    unsigned char* data = header;
+
+    memcpy(data, replayMagic, sizeof(replayMagic));
+    data = PutU16(data + sizeof(replayMagic), REPLAY_VERSION);
+    data = PutU16(data, 0);
+    data = PutU32(data, seed);
+    data = PutU32(data, (unsigned int)width);
+    data = PutU32(data, (unsigned int)height);
+
+    if (fwrite(header, 1, sizeof(header), writer->file) != sizeof(header))
+    {
+        TraceLog(LOG_WARNING, "REPLAY: [%s] Failed to write header", fileName);
+
+        CloseReplayWriter(writer);
+        return false;
+    }
+
+    return true;
+}
+
+void CloseReplayWriter(ReplayWriter* writer)
+{
+    if (writer->file != NULL)
+    {
+        fclose(writer->file);
+    }
+
+    writer->file = NULL;
+}
+
+void WriteReplayObject(ReplayWriter* writer, int x, int z)
+{
+    unsigned char record[5];
+    unsigned char* data = record;
+
+    *data++ = REPLAY_RECORD_OBJECT;
+    data = PutU16(data, (unsigned int)x);
+    data = PutU16(data, (unsigned int)z);
+
+    WriteReplayRecord(writer, record, (int)(data - record));
+}
+
+void WriteReplayCharacter(ReplayWriter* writer, int team, const UnitTemplate* unit)
+{
+    unsigned char record[REPLAY_MAX_RECORD_SIZE];
+    unsigned char* data = record;
+
+    int nameLength = (unit->name != NULL) ? (int)strlen(unit->name) : 0;
+
+    if (nameLength > REPLAY_MAX_NAME - 1)
+    {
+        nameLength = REPLAY_MAX_NAME - 1;
+    }
+
+    *data++ = REPLAY_RECORD_CHARACTER;
+    *data++ = (unsigned char)team;
+    data = PutU16(data, (unsigned int)unit->speed);
+    data = PutU16(data, (unsigned int)unit->baseInitiative);
+    data = PutU16(data, (unsigned int)unit->health);
+    data = PutU16(data, (unsigned int)unit->maxHealth);
+    data = PutU16(data, (unsigned int)unit->minAttack);
+    data = PutU16(data, (unsigned int)unit->maxAttack);
+    *data++ = (unsigned char)nameLength;
+    memcpy(data, unit->name, nameLength);
+    data += nameLength;
+
+    WriteReplayRecord(writer, record, (int)(data - record));
+}
+
+void WriteReplayBegin(ReplayWriter* writer)
+{
+    unsigned char record = REPLAY_RECORD_BEGIN;
+
+    WriteReplayRecord(writer, &record, 1);
+
+    if (writer->file != NULL)
+    {
+        fflush(writer->file);
+    }
+}
+
+void WriteReplayAction(ReplayWriter* writer, Action action)
+{
+    unsigned char record[10];
+    unsigned char* data = record;
+
+    *data++ = REPLAY_RECORD_ACTION;
+    *data++ = (unsigned char)action.type;
+    data = PutU16(data, (unsigned int)action.entity);
+    data = PutU32(data, (unsigned int)action.tileIndex);
+    data = PutU16(data, (action.target == ENTITY_NONE) ? REPLAY_NO_TARGET : (unsigned int)action.target);
+
+    WriteReplayRecord(writer, record, (int)(data - record));
+
+    if (writer->file != NULL)
+    {
+        fflush(writer->file);
+    }
+}
+
+//----------------------------------------------------------------------------------
+// Replay Functions Definition
+//----------------------------------------------------------------------------------
+// Decode one record, returns its size or 0 if the data ends mid record or is invalid.
+static int ReadReplayRecord(const unsigned char* data, int dataSize, ReplayRecord* record)
+{
+    *record = (ReplayRecord){ 0 };
+    record->type = data[0];
+
+    switch (record->type)
+    {
+        case REPLAY_RECORD_OBJECT:
+        {
+            if (dataSize < 5) return 0;
+
+            record->x = (int)GetU16(data + 1);
+            record->z = (int)GetU16(data + 3);
+
+            return 5;
+        }
+        case REPLAY_RECORD_CHARACTER:
+        {
+            if (dataSize < 15 || dataSize < 15 + data[14] || data[14] >= REPLAY_MAX_NAME || data[1] >= BATTLE_TEAMS) return 0;
+
+            record->team = data[1];
+            record->unit.speed = (int)GetU16(data + 2);
+            record->unit.baseInitiative = (int)GetU16(data + 4);
+            record->unit.health = (int)GetU16(data + 6);
+            record->unit.maxHealth = (int)GetU16(data + 8);
+            record->unit.minAttack = (int)GetU16(data + 10);
+            record->unit.maxAttack = (int)GetU16(data + 12);
+            memcpy(record->name, data + 15, data[14]);
+
+            return 15 + data[14];
+        }
+        case REPLAY_RECORD_BEGIN:
+        {
+            return 1;
+        }
+        case REPLAY_RECORD_ACTION:
+        {
+            if (dataSize < 10) return 0;
+
+            unsigned int target = GetU16(data + 8);
+
+            record->action.type = data[1];
+            record->action.entity = (int)GetU16(data + 2);
+            record->action.tileIndex = (int)GetU32(data + 4);
+            record->action.target = (target == REPLAY_NO_TARGET) ? ENTITY_NONE : (int)target;
+
+            return 10;
+        }
+        default: break;
+    }
+
+    return 0;
+}
+
+bool LoadReplay(Replay* replay, const char* fileName)
+{
+    *replay = (Replay){ 0 };
+
+    int dataSize = 0;
+    unsigned char* fileData = LoadFileData(fileName, &dataSize);
+
+    if (fileData == NULL)
+    {
+        return false;
+    }
+
+    if (dataSize < REPLAY_HEADER_SIZE || memcmp(fileData, replayMagic, sizeof(replayMagic)) != 0 ||
+        GetU16(fileData + 4) != REPLAY_VERSION)
+    {
+        TraceLog(LOG_WARNING, "REPLAY: [%s] Not a replay file or unsupported version", fileName);
+
+        UnloadFileData(fileData);
+        return false;
+    }
+
+    replay->seed = GetU32(fileData + 8);
+    replay->width = (int)GetU32(fileData + 12);
+    replay->height = (int)GetU32(fileData + 16);
+
+    if (replay->width <= 0 || replay->height <= 0 || (long long)replay->width * replay->height > INT_MAX)
+    {
+        TraceLog(LOG_WARNING, "REPLAY: [%s] Invalid map size %ix%i", fileName, replay->width, replay->height);
+
+        UnloadFileData(fileData);
+        *replay = (Replay){ 0 };
+        return false;
+    }
+
+    int maxRecords = 0;
+    int offset = REPLAY_HEADER_SIZE;
+
+    while (offset < dataSize)
+    {
+        if (replay->numRecords == maxRecords)
+        {
+            maxRecords = (maxRecords == 0) ? 64 : maxRecords * 2;
+            replay->records = (ReplayRecord*)MemRealloc(replay->records, maxRecords * sizeof(ReplayRecord));
+        }
+
+        int recordSize = ReadReplayRecord(fileData + offset, dataSize - offset, &replay->records[replay->numRecords]);
+
+        // The game was closed mid write, keep what was complete.
+        if (recordSize == 0)
+        {
+            TraceLog(LOG_WARNING, "REPLAY: [%s] Broken record at byte %i, rest of the file ignored", fileName, offset);
+            break;
+        }
+
+        replay->numRecords++;
+        offset += recordSize;
+    }
+
+    UnloadFileData(fileData);
+
+    TraceLog(LOG_INFO, "REPLAY: [%s] Replay loaded successfully (%i records)", fileName, replay->numRecords);
+
+    return true;
+}
+
+void UnloadReplay(Replay* replay)
+{
+    MemFree(replay->records);
+
+    *replay = (Replay){ 0 };
+}
+
+//----------------------------------------------------------------------------------
+// Replay Player Functions Definition
+//----------------------------------------------------------------------------------
+static void ApplyReplayRecord(ReplayPlayer* player, const ReplayRecord* record)
+{
+    Battle* battle = &player->battle;
+
+    switch (record->type)
+    {
+        case REPLAY_RECORD_OBJECT: SpawnBattleObject(battle, record->x, record->z); break;
+        case REPLAY_RECORD_CHARACTER:
+        {
+            UnitTemplate unit = record->unit;
+            unit.name = record->name;
+
+            SpawnBattleCharacter(battle, record->team, &unit);
+        } break;
+        case REPLAY_RECORD_BEGIN: BeginBattle(battle); break;
+        case REPLAY_RECORD_ACTION:
+        {
+            QueueBattleAction(battle, record->action);
+
+            if (UpdateBattle(battle) == 0)
+            {
+                TraceLog(LOG_WARNING, "REPLAY: Action of record %i is not valid, replay out of sync", player->record);
+                player->isDesynced = true;
+            }
+        } break;
+        default: break;
+    }
+
+    player->record++;
+}
+
+static void SaveReplaySnapshot(ReplayPlayer* player)
+{
+    if (player->numSnapshots == player->maxSnapshots)
+    {
+        player->maxSnapshots = (player->maxSnapshots == 0) ? 8 : player->maxSnapshots * 2;
+        player->snapshots = (ReplaySnapshot*)MemRealloc(player->snapshots, player->maxSnapshots * sizeof(ReplaySnapshot));
+    }
+
+    ReplaySnapshot* snapshot = &player->snapshots[player->numSnapshots++];
+    *snapshot = (ReplaySnapshot){ 0 };
+
+    SaveBattleSnapshot(&player->battle, &snapshot->battle);
+    snapshot->record = player->record;
+}
+
+// Play the spawns of the replay, the player is left at the first turn.
+bool LoadReplayPlayer(ReplayPlayer* player, const Replay* replay)
+{
+    *player = (ReplayPlayer){ 0 };
+    player->replay = replay;
+
+    if (LoadBattle(&player->battle, replay->width, replay->height, REPLAY_MAX_LOADED_CHUNKS, replay->seed) == false)
+    {
+        return false;
+    }
+
+    while (player->record < replay->numRecords)
+    {
+        const ReplayRecord* record = &replay->records[player->record];
+
+        ApplyReplayRecord(player, record);
+
+        if (record->type == REPLAY_RECORD_BEGIN)
+        {
+            SaveReplaySnapshot(player);
+            return true;
+        }
+    }
+
+    TraceLog(LOG_WARNING, "REPLAY: Replay has no battle start");
+
+    UnloadReplayPlayer(player);
+    return false;
+}
+
+void UnloadReplayPlayer(ReplayPlayer* player)
+{
+    for (int i = 0; i < player->numSnapshots; i++)
+    {
+        UnloadBattleSnapshot(&player->snapshots[i].battle);
+    }
+
+    MemFree(player->snapshots);
+    UnloadBattle(&player->battle);
+
+    *player = (ReplayPlayer){ 0 };
+}
+
+// Play the next turn. Returns false at the end of the replay or if it went out of sync.
+bool StepReplay(ReplayPlayer* player)
+{
+    const Replay* replay = player->replay;
+    int numTurns = player->battle.numTurns;
+
+    while (player->isDesynced == false && player->record < replay->numRecords)
+    {
+        ApplyReplayRecord(player, &replay->records[player->record]);
+
+        if (player->battle.numTurns != numTurns)
+        {
+            // Snapshots are kept in turn order, snapshot i is at turn i * REPLAY_SNAPSHOT_INTERVAL.
+            if (player->battle.numTurns == player->numSnapshots * REPLAY_SNAPSHOT_INTERVAL)
+            {
+                SaveReplaySnapshot(player);
+            }
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Jump to the start of a turn, or as close as the replay goes.
+void SeekReplay(ReplayPlayer* player, int turn)
+{
+    if (turn < 0)
+    {
+        turn = 0;
+    }
+
+    int snapshotIndex = turn / REPLAY_SNAPSHOT_INTERVAL;
+
+    if (snapshotIndex > player->numSnapshots - 1)
+    {
+        snapshotIndex = player->numSnapshots - 1;
+    }
+
+    ReplaySnapshot* snapshot = &player->snapshots[snapshotIndex];
+
+    // Only go through a snapshot if it is closer than playing on from the current turn.
+    if (turn < player->battle.numTurns || snapshot->battle.numTurns > player->battle.numTurns)
+    {
+        LoadBattleSnapshot(&player->battle, &snapshot->battle);
+        player->record = snapshot->record;
+        player->isDesynced = false;
+    }
+
+    while (player->battle.numTurns < turn && StepReplay(player));
+}
@@ -0,0 +1,97 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "battle.h"
+
+#include <stdio.h>
+
+#define REPLAY_VERSION 2
+#define REPLAY_MAX_NAME 64
+#define REPLAY_SNAPSHOT_INTERVAL 32		// Turns between the snapshots SeekReplay() starts from.
+
+enum ReplayRecordType
+{
+	REPLAY_RECORD_OBJECT,
+	REPLAY_RECORD_CHARACTER,
+	REPLAY_RECORD_BEGIN,
+	REPLAY_RECORD_ACTION
+};
+
+// One decoded record. Only the members of the record type are set.
+typedef struct ReplayRecord
+{
+	int type;
+
+	int x;						// REPLAY_RECORD_OBJECT
+	int z;
+
+	int team;					// REPLAY_RECORD_CHARACTER
+	UnitTemplate unit;
+	char name[REPLAY_MAX_NAME];
+
+	Action action;				// REPLAY_RECORD_ACTION
+
+} ReplayRecord;
+
+// Appends records to a replay file while a battle is played. Every action is flushed, so
+// the file is usable up to the last turn even if the game is closed mid battle. The typedef
+// is in battle.h.
+struct ReplayWriter
+{
+	FILE* file;
+	int numRecords;
+
+};
+
+// Whole replay file decoded to memory.
+typedef struct Replay
+{
+	unsigned int seed;
+	int width;
+	int height;
+
+	ReplayRecord* records;
+	int numRecords;
+
+} Replay;
+
+typedef struct ReplaySnapshot
+{
+	BattleSnapshot battle;
+	int record;					// Next record to apply after loading the snapshot.
+
+} ReplaySnapshot;
+
+// Re-simulates a replay without rendering. A snapshot is kept every REPLAY_SNAPSHOT_INTERVAL
+// turns played, so seeking back only replays the turns after the closest snapshot.
+typedef struct ReplayPlayer
+{
+	const Replay* replay;
+	Battle battle;
+	int record;					// Next record to apply.
+
+	ReplaySnapshot* snapshots;
+	int numSnapshots;
+	int maxSnapshots;
+
+	bool isDesynced;			// A recorded action was not valid, the rules have changed.
+
+} ReplayPlayer;
+
+bool OpenReplayWriter(ReplayWriter* writer, const char* fileName, unsigned int seed, int width, int height);
+void CloseReplayWriter(ReplayWriter* writer);
+
+void WriteReplayObject(ReplayWriter* writer, int x, int z);
+void WriteReplayCharacter(ReplayWriter* writer, int team, const UnitTemplate* unit);
+void WriteReplayBegin(ReplayWriter* writer);
+void WriteReplayAction(ReplayWriter* writer, Action action);
+
+bool LoadReplay(Replay* replay, const char* fileName);
+void UnloadReplay(Replay* replay);
+
+bool LoadReplayPlayer(ReplayPlayer* player, const Replay* replay);
+void UnloadReplayPlayer(ReplayPlayer* player);
+bool StepReplay(ReplayPlayer* player);
+void SeekReplay(ReplayPlayer* player, int turn);
+
+#endif
@@ -0,0 +1,83 @@
+/**********************************************************************************************
+*
+*   Rng - Seedable random numbers
+*
+*   PCG-XSH-RR, see https://www.pcg-random.org. 64 bits of state, 32 bit output.
+*   GetRngHash() is the stateless counterpart for values looked up in any order, like the
+*   heights of terrain chunks generated on demand.
+*
+**********************************************************************************************/
+
+#include "rng.h"
+
+//----------------------------------------------------------------------------------
+// Rng Functions Definition
+//----------------------------------------------------------------------------------
+void SeedRng(Rng* rng, uint64_t seed, uint64_t stream)
+{
+    rng->state = 0;
+    rng->increment = (stream << 1) | 1;
+
+    GetRngNext(rng);
+    rng->state += seed;
+    GetRngNext(rng);
+}
+
+uint32_t GetRngNext(Rng* rng)
+{
+    uint64_t state = rng->state;
+    rng->state = state * 6364136223846793005ULL + rng->increment;
+
+    uint32_t xorShifted = (uint32_t)(((state >> 18) ^ state) >> 27);
+    uint32_t rotation = (uint32_t)(state >> 59);
+
+    return (xorShifted >> rotation) | (xorShifted << ((0u - rotation) & 31));
+}
+
+// Random value between min and max, both included. Same contract as GetRandomValue().
+int GetRngValue(Rng* rng, int min, int max)
+{
+    if (min > max)
+    {
+        int temp = max;
+        max = min;
+        min = temp;
+    }
+
+    uint32_t range = (uint32_t)((int64_t)max - min) + 1;
+
+    if (range == 0)
+    {
+        return (int)GetRngNext(rng);
+    }
+
+    // Multiply instead of modulo, rejecting the few values that would bias the result.
+    uint64_t product = (uint64_t)GetRngNext(rng) * range;
+    uint32_t low = (uint32_t)product;
+
+    if (low < range)
+    {
+        uint32_t threshold = (0u - range) % range;
+
+        while (low < threshold)
+        {
+            product = (uint64_t)GetRngNext(rng) * range;
+            low = (uint32_t)product;
+        }
+    }
+
+    return (int)((int64_t)min + (int64_t)(product >> 32));
+}
+
+// Random value for the counter, the same for the same seed, stream and counter.
+uint32_t GetRngHash(uint64_t seed, uint64_t stream, uint64_t counter)
+{
+    // SplitMix64 finalizer over the key.
+    uint64_t hash = seed * 0x9e3779b97f4a7c15ULL + (stream << 1 | 1) * 0xbf58476d1ce4e5b9ULL + counter;
+
+    hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebULL;
+    hash ^= hash >> 31;
+
+    return (uint32_t)(hash >> 32);
+}
@@ -0,0 +1,31 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>
+
+// Every subsystem draws from a stream of its own, so e.g. an extra spawn roll never shifts
+// the damage rolls of a replayed battle.
+enum RngStream
+{
+	RNG_STREAM_TERRAIN,
+	RNG_STREAM_SPAWN,
+	RNG_STREAM_COMBAT,
+	RNG_STREAM_MOISTURE
+};
+
+// PCG32 random number generator. Generators with the same seed but a different stream give
+// independent sequences, so every battle or worker can own one instead of sharing global state.
+typedef struct Rng
+{
+	uint64_t state;
+	uint64_t increment;			// Selects the stream, always odd.
+
+} Rng;
+
+void SeedRng(Rng* rng, uint64_t seed, uint64_t stream);
+uint32_t GetRngNext(Rng* rng);
+int GetRngValue(Rng* rng, int min, int max);
+
+uint32_t GetRngHash(uint64_t seed, uint64_t stream, uint64_t counter);
+
+#endif
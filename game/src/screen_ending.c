@@ -32,6 +32,9 @@
 static int framesCounter = 0;
 static int finishScreen = 0;
 
+static AssetHandle fontAsset = ASSET_NONE;
+static AssetHandle fxCoinAsset = ASSET_NONE;
+
 //----------------------------------------------------------------------------------
 // Ending Screen Functions Definition
 //----------------------------------------------------------------------------------
@@ -42,6 +45,9 @@ void InitEndingScreen(void)
     // TODO: Initialize ENDING screen variables here!
     framesCounter = 0;
     finishScreen = 0;
+
+    fontAsset = LoadAsset(assets, ASSET_FONT, FONT_FILE_NAME);
+    fxCoinAsset = LoadAsset(assets, ASSET_SOUND, COIN_SOUND_FILE_NAME);
 }
 
 // Ending Screen Update logic
@@ -53,7 +59,7 @@ void UpdateEndingScreen(void)
     if (IsKeyPressed(KEY_ENTER) || IsGestureDetected(GESTURE_TAP))
     {
         finishScreen = 1;
-        PlaySound(fxCoin);
+        PlaySound(GetAssetSound(assets, fxCoinAsset));
     }
 }
 
@@ -64,6 +70,7 @@ void DrawEndingScreen(void)
     DrawRectangle(0, 0, GetScreenWidth(), GetScreenHeight(), BLUE);
 
     Vector2 pos = { 20, 10 };
+    Font font = GetAssetFont(assets, fontAsset);
     DrawTextEx(font, "ENDING SCREEN", pos, font.baseSize*3.0f, 4, DARKBLUE);
     DrawText("YOU WIN!!! PRESS ENTER or TAP to RETURN to TITLE SCREEN", 120, 220, 20, DARKBLUE);
 }
@@ -72,6 +79,8 @@ void DrawEndingScreen(void)
 void UnloadEndingScreen(void)
 {
     // TODO: Unload ENDING screen variables here!
+    UnloadAsset(assets, fontAsset);
+    UnloadAsset(assets, fxCoinAsset);
 }
 
 // Ending Screen should finish?
@@ -32,19 +32,47 @@
 #include "entity.h"
 #include "level.h"
 #include "button.h"
+#include "terrain.h"
+#include "battle.h"
+#include "replay.h"
+#include "battle_save.h"
+#include "battle_thread.h"
+#include "depth_sort.h"
+#include "billboard.h"
 
 //----------------------------------------------------------------------------------
 // Module Variables Definition (local)
 //----------------------------------------------------------------------------------
-#define MAP_WIDTH 10
-#define MAP_HEIGHT 8
-
-#define MAP_HEIGHT_VERTICES MAP_HEIGHT + 1
-#define MAP_WIDTH_VERTICES MAP_WIDTH + 1
-#define TILE_SIZE 1
-
-#define MAX_ENTITIES 24
-#define SPAWN_ZONES 2        // MAP DATA KNOWS HOW MANY ZONES.
+#define DEFAULT_MAP_WIDTH 10
+#define DEFAULT_MAP_HEIGHT 8
+#define MAX_LOADED_CHUNKS 64     // 64 chunks of 32x32 tiles, roughly 7 MB of tile data
+
+#define MOVEMENT_SPEED 6.0f  // Tiles per second when a unit walks along its path.
+#define REPLAY_FILE_NAME "last_battle.replay"
+#define QUICKSAVE_FILE_NAME "quicksave.battle"
+
+// Sprite files in SpriteID order. Grass stays a texture of its own, the terrain repeats it per tile.
+static const char* spriteFileNames[SPRITE_COUNT] = {
+    "resources/blank.png",
+    "resources/tree.png",
+    "resources/rock.png",
+    "resources/orc.png",
+    "resources/orc_dead.png",
+    "resources/orc_face.png",
+    "resources/wizard.png",
+    "resources/wizard_dead.png",
+    "resources/wizard_face.png",
+    "resources/knight.png",
+    "resources/knight_face.png",
+    "resources/morko.png",
+    "resources/morko_face.png",
+    "resources/goblin.png",
+    "resources/unit_dead.png",
+};
+
+static AssetHandle spriteAssets[SPRITE_COUNT] = { 0 };     // Registered on init, a sprite loads when it is first drawn.
+static AssetHandle fontAsset = ASSET_NONE;
+static AssetHandle grassTextureAsset = ASSET_NONE;
 
 void DrawQuad3D(Camera camera, Vector3 bottomLeft, Vector3 bottomRight, Vector3 topRight, Vector3 topLeft, Color tint)
 {
@@ -119,48 +147,41 @@ void DrawGameGrid(int mapWidth, int mapHeight, int spacing)
     rlEnd();
 }
 
-void DrawEntities(Entity entities[], int numEntities, int selectedUnitID, Camera camera)
+// The moving entity is drawn at movingPosition instead of its tile.
+void DrawEntities(Entities* entities, int selectedUnitID, int movingEntity, Vector3 movingPosition, Camera camera, DepthSorter* sorter, BillboardBatch* batch)
 {
-    // HAX: pls fix at some point, MAX_ENTITIES?
-    int renderQueue[128] = { 0 };
+    int numEntities = entities->numEntities;
+
+    // Back to front, squared distance keeps the order without a sqrt per entity.
+    float* depths = BeginDepthSort(sorter, numEntities);
 
     for (int i = 0; i < numEntities; i++)
     {
-        renderQueue[i] = i;
+        depths[i] = Vector3DistanceSqr((i == movingEntity) ? movingPosition : entities->positions[i], camera.position);
     }
 
-    for (int i = 0; i < numEntities - 1; i++)
-    {
-        float distanceA = Vector3Distance(entities[renderQueue[i]].position, camera.position);
+    const int* renderQueue = EndDepthSort(sorter);
 
-        for (int j = i + 1; j < numEntities; j++)
-        {
-            float distanceB = Vector3Distance(entities[renderQueue[j]].position, camera.position);
+    Vector3 up = { 0.0f, -1.0f, 0.0f };
+    int selectedTeamID = (selectedUnitID != -1) ? entities->teamIDs[selectedUnitID] : -1;
 
-            if (distanceA < distanceB)
-            {
-                int temp = renderQueue[i];
-                renderQueue[i] = renderQueue[j];
-                renderQueue[j] = temp;
-                distanceA = distanceB;
-            }
-        }
-    }
+    BeginBillboards(batch, camera, up);
+
+    Vector3 cameraRightVector = batch->right;
+    Sprite healthSprite = GetAssetSprite(assets, spriteAssets[SPRITE_BLANK]);
 
     for (int i = 0; i < numEntities; i++)
     {
-        Entity* entity = &entities[renderQueue[i]];
-        Vector3 entityPos = entity->position;
+        int entity = renderQueue[i];
+        EntityInfo* info = &entities->infos[entity];
+        Vector3 entityPos = (entity == movingEntity) ? movingPosition : entities->positions[entity];
 
         // Don't render deactivated units
-        if (entity->isActive == false)
+        if ((entities->flags[entity] & ENTITY_FLAG_ACTIVE) == 0)
         {
             continue;
         }
 
-        Vector3 up = { 0.0f, -1.0f, 0.0f };
-        Vector2 origin = Vector2Zero();
-        float rotation = 0.0f;
         Color tint = WHITE;
 
         // Render separate from map position.
@@ -168,31 +189,28 @@ void DrawEntities(Entity entities[], int numEntities, int selectedUnitID, Camera
         entityPos.y += -0.5f;
         entityPos.z += 0.5f;
 
-        Texture texture = entity->texture;
-        if (entity->isAlive == false)
+        int spriteID = info->sprite;
+        if ((entities->flags[entity] & ENTITY_FLAG_ALIVE) == 0)
         {
-            texture = entity->deathTexture;
+            spriteID = info->deathSprite;
         }
 
-        // Draw unit/entity.
-        DrawBillboardPro(camera, texture, entity->textureRect, entityPos, up, entity->size, origin, rotation, tint);
+        Sprite sprite = GetAssetSprite(assets, spriteAssets[spriteID]);
+
+        // Draw unit/entity, once its sprite is loaded.
+        if (sprite.texture.id != 0) AddBillboard(batch, sprite.texture, sprite.source, entityPos, info->size, tint);
 
-        if (entity->maxHealth != 0)
+        if (entities->maxHealths[entity] != 0 && healthSprite.texture.id != 0)
         {
             // Draw healthbar.
-            Texture healthTexture = blankTexture;
-            Rectangle healthTextureRect = (Rectangle){ 0.0f, 0.0f, (float)healthTexture.width, (float)healthTexture.height };
             Vector3 healthPos = { 0.0f };
             healthPos.x = entityPos.x;
-            healthPos.y = entityPos.y - entity->size.y * 0.5f - 0.1f;
+            healthPos.y = entityPos.y - info->size.y * 0.5f - 0.1f;
             healthPos.z = entityPos.z;
 
             Vector3 backgroundPos = healthPos;
 
-            Vector3 cameraVector = Vector3Normalize(Vector3Subtract(camera.position, camera.target));
-            Vector3 cameraRightVector = Vector3Normalize(Vector3CrossProduct(camera.up, cameraVector));
-
-            float healthPercentage = (float)entity->health / (float)entity->maxHealth;
+            float healthPercentage = (float)entities->healths[entity] / (float)entities->maxHealths[entity];
 
             // Move healthbar color to the left.
             healthPos.x -= cameraRightVector.x * (1 - healthPercentage) * 0.5f;
@@ -203,49 +221,57 @@ void DrawEntities(Entity entities[], int numEntities, int selectedUnitID, Camera
             backgroundPos.z += cameraRightVector.z * (healthPercentage) * 0.5f;
 
             Color healthBarColor = RED;
-            if (entity->teamID == entities[selectedUnitID].teamID)
+            if (entities->teamIDs[entity] == selectedTeamID)
             {
                 healthBarColor = BLUE;
             }
 
-            DrawBillboardPro(camera, healthTexture, healthTextureRect, backgroundPos, up, (Vector2) { 1.0f - (1.0f * healthPercentage), 0.1f }, origin, rotation, DARKGRAY);
+            AddBillboard(batch, healthSprite.texture, healthSprite.source, backgroundPos, (Vector2) { 1.0f - (1.0f * healthPercentage), 0.1f }, DARKGRAY);
 
             // Draw health bar.
-            DrawBillboardPro(camera, healthTexture, healthTextureRect, healthPos, up, (Vector2) { 1.0f * healthPercentage, 0.1f }, origin, rotation, healthBarColor);
+            AddBillboard(batch, healthSprite.texture, healthSprite.source, healthPos, (Vector2) { 1.0f * healthPercentage, 0.1f }, healthBarColor);
         }
         // TODO FIX.
-        /*if (entities[renderQueue[i]].teamID == currentTurnTeamID && entities[renderQueue[i]].type == ENTITY_TYPE_CHARACTER)
+        /*if (entities->teamIDs[entity] == currentTurnTeamID && entities->types[entity] == ENTITY_TYPE_CHARACTER)
         {
-            DrawBoundingBox(entities[renderQueue[i]].boundingBox, WHITE);
+            DrawBoundingBox(GetEntityBoundingBox(entities, entity), WHITE);
         }*/
     }
+
+    EndBillboards(batch);
 }
 
-void DrawTiles(Tile* tileMap, int mapHeight, int mapWidth, Camera camera)
+void DrawPath(Map* map, Path path)
 {
-    for (int z = 0; z < mapHeight; z++)
-    {
-        for (int x = 0; x < mapWidth; x++)
-        {
-            Tile* tile = &tileMap[z * mapWidth + x];
+    Color color = { WHITE.r, WHITE.g, WHITE.b, 128 };
+    float inset = 0.35f;
 
-            rlSetTexture(tile->texture.id);
-            DrawQuad3D(camera, tile->bottomLeft, tile->bottomRight, tile->topRight, tile->topLeft, (z * mapHeight + x) % 2 ? WHITE : BLUE);
+    rlSetTexture(rlGetTextureIdDefault());
 
-            rlSetTexture(0);
-        }
+    // Skip the start tile, the unit is standing on it.
+    for (int i = 1; i < path.numTiles; i++)
+    {
+        Tile* tile = GetMapTileByIndex(map, path.tileIndices[i]);
+
+        DrawQuad3D(camera,
+            Vector3Add(Vector3Lerp(tile->bottomLeft, tile->topRight, inset), (Vector3) { 0.0f, -0.03f, 0.0f }),
+            Vector3Add(Vector3Lerp(tile->bottomRight, tile->topLeft, inset), (Vector3) { 0.0f, -0.03f, 0.0f }),
+            Vector3Add(Vector3Lerp(tile->topRight, tile->bottomLeft, inset), (Vector3) { 0.0f, -0.03f, 0.0f }),
+            Vector3Add(Vector3Lerp(tile->topLeft, tile->bottomRight, inset), (Vector3) { 0.0f, -0.03f, 0.0f }),
+            color);
     }
+
+    rlSetTexture(0);
 }
 
-void DrawSelectionArea(Tile* selectionTileMap[], int numSelectionTiles, Entity* selectedEntity)
+void DrawSelectionArea(Entities* entities, Tile* selectionTileMap[], int numSelectionTiles, int selectedEntity)
 {
     Color colorNormal = { YELLOW.r, YELLOW.g, YELLOW.b, 96 };
     Color colorEnemy = { RED.r, RED.g, RED.b, 96 };
     Color colorAlly = { BLUE.r, BLUE.g, BLUE.b, 96 };
     Color colorSelected = { WHITE.r, WHITE.g, WHITE.b, 164 };
 
-    // FIX THIS
-    rlSetTexture(blankTexture.id);
+    rlSetTexture(rlGetTextureIdDefault());
 
     for (int i = 0; i < numSelectionTiles; i++)
     {
@@ -255,15 +281,15 @@ void DrawSelectionArea(Tile* selectionTileMap[], int numSelectionTiles, Entity*
 
         Color color = colorNormal;
 
-        if (tile->entity)
+        if (tile->entity != ENTITY_NONE)
         {
-            if (tile->entity->type == ENTITY_TYPE_CHARACTER)
+            if (entities->types[tile->entity] == ENTITY_TYPE_CHARACTER)
             {
                 if (tile->entity == selectedEntity)
                 {
                     color = colorSelected;
                 }
-                else if (tile->entity->teamID == selectedEntity->teamID)
+                else if (entities->teamIDs[tile->entity] == entities->teamIDs[selectedEntity])
                 {
                     color = colorAlly;
                 }
@@ -272,7 +298,7 @@ void DrawSelectionArea(Tile* selectionTileMap[], int numSelectionTiles, Entity*
                     color = colorEnemy;
                 }
             }
-            else if (tile->entity->type == ENTITY_TYPE_TERRAIN_OBJECT)
+            else if (entities->types[tile->entity] == ENTITY_TYPE_TERRAIN_OBJECT)
             {
                 continue;
             }
@@ -296,8 +322,10 @@ void UpdateGameCamera(Camera* camera)
     bool lockView = true;
     bool rotateUp = false;
 
-    float cameraMoveSpeed = 0.09f;
-    float cameraRotationSpeed = 0.03f;
+    // Per second, the camera moves once per frame.
+    float frameTime = GetFrameTime();
+    float cameraMoveSpeed = 5.4f * frameTime;
+    float cameraRotationSpeed = 1.8f * frameTime;
     float cameraMouseMoveSensitivity = 0.003f;
 
     // Camera rotation
@@ -317,7 +345,7 @@ void UpdateGameCamera(Camera* camera)
 
     if (IsKeyDown(KEY_LEFT_SHIFT))
     {
-        cameraMoveSpeed = 0.24f;
+        cameraMoveSpeed = 14.4f * frameTime;
     }
 
     // Keyboard support
@@ -339,22 +367,42 @@ void UpdateGameCamera(Camera* camera)
 static int framesCounter = 0;
 static int finishScreen = 0;
 
-static Tile tileMap[MAP_HEIGHT][MAP_WIDTH] = { 0 };
-static float depthMap[MAP_HEIGHT_VERTICES][MAP_WIDTH_VERTICES];
-static SpawnZone spawnZones[SPAWN_ZONES];
-
-Entity entities[MAX_ENTITIES] = { 0 };
-Entity* entityTurnQueue[MAX_ENTITIES] = { 0 };
-int numEntities = 0;
-int numEntityTurns = 0;
+static int mapWidth = DEFAULT_MAP_WIDTH;
+static int mapHeight = DEFAULT_MAP_HEIGHT;
+static unsigned int battleSeed = 0;
+static bool isSeedSet = false;
+static bool isAiTeam[BATTLE_TEAMS] = { 0 };
+static Battle battle = { 0 };               // Copy of the latest battle frame, drawn and picked from.
+static Battle simulationBattle = { 0 };     // Played on the battle thread.
+static BattleThread* battleThread = NULL;
+static const BattleFrame* battleFrame = NULL;
+static unsigned int battleFrameVersion = 0;
+static unsigned int numQueuedActions = 0;
+static ReplayWriter replayWriter = { 0 };
+static Terrain terrain = { 0 };
+static DepthSorter renderSorter = { 0 };
+static BillboardBatch billboardBatch = { 0 };
 
 RayCollision hitMapWorld = { 0 };
 Vector3 selectionRectPos = { 0 };
-Tile* selectionTiles[MAP_HEIGHT * MAP_WIDTH] = { 0 };
+Tile* hoverTile = NULL;
+Tile** selectionTiles = NULL;
 int numSelectionTiles = 0;
+int maxSelectionTiles = 0;
 
 int selection = -1;
 bool targetingMode = false;
+int attackTarget = ENTITY_NONE;
+
+int movingEntity = ENTITY_NONE;
+Action moveAction = { 0 };
+int* movePath = NULL;
+int numMovePathTiles = 0;
+int maxMovePathTiles = 0;
+float moveProgress = 0.0f;
+Vector3 movePosition = { 0 };
+Vector3 previousMovePosition = { 0 };   // Position at the fixed update before, drawing blends between the two.
+bool isMoveQueued = false;              // The walk is over, the unit waits there for its action to be applied.
 
 Button endTurnButton = { 0 };
 Button attackButton = { 0 };
@@ -362,129 +410,91 @@ Button attackButton = { 0 };
 //----------------------------------------------------------------------------------
 // Gameplay Screen Functions Definition
 //----------------------------------------------------------------------------------
-void SpawnCharacter(SpawnZone* spawnZone, Texture2D* texture, Texture2D* deathTexture, int speed, int baseInitiative, int health, int maxHealth, int minAttack, int maxAttack, char* name)
+void SetEntitySprites(EntityInfo* info, int sprite, int deathSprite)
+{
+    info->sprite = sprite;
+    info->deathSprite = deathSprite;
+}
+
+void SpawnCharacter(int team, SpriteID sprite, SpriteID deathSprite, const UnitTemplate* unit)
 {
-    int numTiles = spawnZone->numTiles;
+    int entity = SpawnBattleCharacter(&simulationBattle, team, unit);
 
-    for (int i = 0; i < numTiles; i++)
+    if (entity != ENTITY_NONE)
     {
-        int randomValue = GetRandomValue(0, numTiles - 1);
-        if (spawnZone->tiles[randomValue]->entity == NULL)
-        {
-            Vector3 spawnPosition = { 0 };
-            Tile* spawnTile = spawnZone->tiles[randomValue];
-
-            spawnPosition.x = spawnTile->bottomLeft.x;
-            spawnPosition.z = spawnTile->bottomLeft.z;
-            spawnPosition.y = spawnTile->entityPos;
-
-            Entity* entity = &entities[numEntities];
-            entityTurnQueue[numEntityTurns] = entity;
-
-            entity->isActive = true;
-            entity->isAlive = true;
-            entity->target = NULL;
-
-            entity->position = spawnPosition;
-            entity->size = (Vector2){ 1.0f, 1.0f };
-            entity->texture = *texture;
-            entity->deathTexture = *deathTexture;
-            entity->textureRect = (Rectangle){ 0.0f, 0.0f, (float)(*texture).width, (float)(*texture).height };
-            entity->teamID = spawnZone->playerID;
-            entity->type = ENTITY_TYPE_CHARACTER;
-            entity->isBlockingMovement = true;
-            entity->speed = speed;
-            TextCopy(entity->name, name);
-            entity->baseInitiative = baseInitiative;
-            entity->currentInitiative = baseInitiative;
-            entity->health = health;
-            entity->maxHealth = maxHealth;
-            entity->minAttack = minAttack;
-            entity->maxAttack = maxAttack;
-            numEntities++;
-            numEntityTurns++;
-
-            entity->tile = spawnTile;
-            spawnTile->entity = entity;
-
-            return;
-        }
+        SetEntitySprites(&simulationBattle.entities.infos[entity], sprite, deathSprite);
     }
 }
 
-void SpawnTerrainObject(int x, int z, Texture2D* texture)
+void SpawnTerrainObject(int x, int z, SpriteID sprite)
 {
-    Entity* entity = &entities[numEntities];
-    numEntities++;
+    int entity = SpawnBattleObject(&simulationBattle, x, z);
 
-    entity->isActive = true;
-    entity->isAlive = true;
-
-    Tile* spawnTile = &tileMap[z][x];
-    Vector3 spawnPosition = { 0 };
-
-    spawnPosition.x = spawnTile->bottomLeft.x;
-    spawnPosition.z = spawnTile->bottomLeft.z;
-    spawnPosition.y = spawnTile->entityPos;
-
-    entity->position = spawnPosition;
-    entity->size = (Vector2){ 1.0f, 1.0f };
-    entity->texture = *texture;
-    entity->textureRect = (Rectangle){ 0.0f, 0.0f, (float)(*texture).width, (float)(*texture).height };
-    entity->type = ENTITY_TYPE_TERRAIN_OBJECT;
-    entity->isBlockingMovement = true;
-
-    entity->tile = spawnTile;
-    spawnTile->entity = entity;
+    if (entity != ENTITY_NONE)
+    {
+        SetEntitySprites(&simulationBattle.entities.infos[entity], sprite, sprite);
+    }
 }
 
-void RemoveEntity(Entity* entity)
+bool IsEnemy(int entity)
 {
-    entity->tile->entity = NULL;
-    entity->isActive = false;
+    return IsBattleEnemy(&battle, selection, entity);
 }
 
-void KillEntity(Entity* entity)
+void AddSelectionTile(Tile* tile)
 {
-    entity->isAlive = false;
-    entity->isBlockingMovement = false;
+    if (numSelectionTiles == maxSelectionTiles)
+    {
+        maxSelectionTiles = (maxSelectionTiles == 0) ? 64 : maxSelectionTiles * 2;
+        selectionTiles = (Tile**)MemRealloc(selectionTiles, maxSelectionTiles * sizeof(Tile*));
+    }
+
+    selectionTiles[numSelectionTiles] = tile;
+    numSelectionTiles++;
+
+    SelectTile(&battle.map, tile);
 }
 
-bool IsEnemy(Entity* entity)
+void ClearSelectionTiles(void)
 {
-    Entity* selectedEntity = &entities[selection];
+    numSelectionTiles = 0;
+    ClearTileSelection(&battle.map);
+}
 
-    if (selectedEntity->teamID != entity->teamID)
-    {
-        return true;
-    }
-    else
-    {
-        return false;
-    }
+bool IsTileSelectable(Tile* tile)
+{
+    return IsTileSelected(&battle.map, tile);
 }
 
 void SelectEntity(int entityIndex)
 {
-    numSelectionTiles = 0;
+    ClearSelectionTiles();
     selection = entityIndex;
-    Entity* entity = &entities[selection];
 
-    if (entity->isAlive == true)
+    Entities* entities = &battle.entities;
+
+    if (entities->flags[selection] & ENTITY_FLAG_ALIVE)
     {
-        for (int z = 0; z < MAP_HEIGHT; z++)
+        // Add moveable tiles, the battle thread searched them for the active unit.
+        for (int i = 0; i < battleFrame->numReachableTiles; i++)
+        {
+            AddSelectionTile(GetMapTileByIndex(&battle.map, battleFrame->reachableTiles[i]));
+        }
+
+        // Add tiles with an enemy entity in melee range of a moveable tile.
+        for (int i = 0; i < battleFrame->numReachableTiles; i++)
         {
-            for (int x = 0; x < MAP_WIDTH; x++)
+            Tile* tile = GetMapTileByIndex(&battle.map, battleFrame->reachableTiles[i]);
+
+            for (int z = tile->z - 1; z <= tile->z + 1; z++)
             {
-                Tile* tile = &tileMap[z][x];
-                float tileDistance = Vector2Distance((Vector2) { entity->position.x + 0.5f, entity->position.z + 0.5f }, tile->tileCenterPos);
+                for (int x = tile->x - 1; x <= tile->x + 1; x++)
+                {
+                    Tile* neighbour = GetMapTile(&battle.map, x, z);
 
-                {   
-                    // Add moveable tiles and tiles with an enemy entity in melee range.
-                    if ((tileDistance <= entity->speed && tile->walkable) || (tileDistance <= (float)entity->speed + 1.45f && tile->entity && IsEnemy(tile->entity)))
+                    if (neighbour && neighbour->entity != ENTITY_NONE && IsBattleTarget(&battle, selection, neighbour->entity) && IsTileSelectable(neighbour) == false)
                     {
-                        selectionTiles[numSelectionTiles] = tile;
-                        numSelectionTiles++;
+                        AddSelectionTile(neighbour);
                     }
                 }
             }
@@ -492,166 +502,254 @@ void SelectEntity(int entityIndex)
     }
 }
 
-bool IsTileSelectable(Tile* tile)
+void BeginTurn()
 {
-    for (int i = 0; i < numSelectionTiles; i++)
+    if (battle.isFinished)
     {
-        if (tile == selectionTiles[i])
-        {
-            return true;
-        }
+        finishScreen = 1;
+        return;
     }
-    return false;
+    else
+    {
+        SelectEntity(battle.activeEntity);
+    }
+}
+
+// The battle applied an action and moved on to the next unit.
+void EndTurn(void)
+{
+    selection = -1;
+    ClearSelectionTiles();
+
+    targetingMode = false;
+    attackTarget = ENTITY_NONE;
+    TextCopy(attackButton.text, "ATTACK");
+
+    BeginTurn();
 }
 
-void SortEntityTurnQueue()
+void BeginEntityMovement(Action action, Path path)
 {
-    for (int i = 0; i < numEntityTurns - 1; i++)
+    if (path.numTiles > maxMovePathTiles)
     {
-        for (int j = i + 1; j < numEntityTurns; j++)
-        {
-            Entity* entityA = entityTurnQueue[i];
-            Entity* entityB = entityTurnQueue[j];
+        maxMovePathTiles = path.numTiles;
+        movePath = (int*)MemRealloc(movePath, maxMovePathTiles * sizeof(int));
+    }
 
-            if (entityA->currentInitiative > entityB->currentInitiative)
-            {
-                entityTurnQueue[i] = entityB;
-                entityTurnQueue[j] = entityA;
-            }
-        }
+    for (int i = 0; i < path.numTiles; i++)
+    {
+        movePath[i] = path.tileIndices[i];
+    }
+
+    numMovePathTiles = path.numTiles;
+    moveProgress = 0.0f;
+    movingEntity = action.entity;
+    moveAction = action;
+    movePosition = battle.entities.positions[movingEntity];
+    previousMovePosition = movePosition;
+}
+
+void QueueAction(Action action)
+{
+    if (QueueBattleThreadAction(battleThread, action))
+    {
+        numQueuedActions++;
     }
 }
 
-void BeginTurn()
+// The walk is only animated, the battle thread moves the unit and resolves the attack once
+// the action is applied.
+void FinishEntityMovement(void)
 {
-    SortEntityTurnQueue();
-    Entity* currentEntity = NULL;
+    movePosition = GetTileEntityPosition(GetMapTileByIndex(&battle.map, movePath[numMovePathTiles - 1]));
+    previousMovePosition = movePosition;
+    isMoveQueued = true;
 
-    for (int i = 0; i < numEntityTurns; i++)
+    QueueAction(moveAction);
+}
+
+// Walk the moving unit along its path, one tile at a time. Runs in fixed updates.
+void UpdateEntityMovement(void)
+{
+    if (isMoveQueued)
     {
-        if (entityTurnQueue[i]->isAlive)
-        {
-            currentEntity = entityTurnQueue[i];
-            break;
-        }
+        return;
     }
 
-    if (currentEntity == NULL)
+    previousMovePosition = movePosition;
+    moveProgress += FIXED_TIME_STEP * MOVEMENT_SPEED;
+
+    int step = (int)moveProgress;
+
+    if (step >= numMovePathTiles - 1)
     {
-        finishScreen = 1;
+        FinishEntityMovement();
         return;
     }
-    else
+
+    Tile* fromTile = GetMapTileByIndex(&battle.map, movePath[step]);
+    Tile* toTile = GetMapTileByIndex(&battle.map, movePath[step + 1]);
+
+    movePosition = Vector3Lerp(GetTileEntityPosition(fromTile), GetTileEntityPosition(toTile), moveProgress - step);
+}
+
+// Copy the latest frame of the battle thread, if there is a new one.
+void UpdateBattleView(void)
+{
+    battleFrame = GetBattleFrame(battleThread);
+
+    if (battleFrame->version == battleFrameVersion)
     {
-        SelectEntity((int)(currentEntity - &entities[0]));
-        int selectionInitiative = currentEntity->currentInitiative;
+        return;
+    }
 
-        for (int i = 0; i < MAX_ENTITIES; i++)
-        {
-            Entity* entity = &entities[i];
+    int numTurns = battle.numTurns;
 
-            if (entity->isAlive && entity->type == ENTITY_TYPE_CHARACTER)
-            {
-                entity->currentInitiative -= selectionInitiative;
-            }
-        }
+    LoadBattleSnapshot(&battle, &battleFrame->battle);
+    battleFrameVersion = battleFrame->version;
+
+    // The walked unit is drawn from the battle again once its action is in.
+    if (isMoveQueued && battleFrame->numActions == numQueuedActions)
+    {
+        movingEntity = ENTITY_NONE;
+        isMoveQueued = false;
+    }
+
+    if (battle.numTurns != numTurns)
+    {
+        EndTurn();
     }
 }
 
-void EndTurn()
+void QuickSaveBattle(void)
 {
-    entities[selection].currentInitiative = entities[selection].baseInitiative;
-    selection = -1;
-    numSelectionTiles = 0;
+    double startTime = GetTime();
+    Battle* threadBattle = LockBattleThread(battleThread);
 
-    targetingMode = false;
-    TextCopy(attackButton.text, "ATTACK");
-
-    int teamUnitCount[] = { 0, 0 };
-    
-    for (int i = 0; i < MAX_ENTITIES; i++)
+    if (SaveBattleState(threadBattle, QUICKSAVE_FILE_NAME))
     {
-        Entity* entity = &entities[i];
-        
-        if (entity->isAlive && entity->type == ENTITY_TYPE_CHARACTER)
-        {
-            teamUnitCount[entity->teamID]++;
-        }
+        TraceLog(LOG_INFO, "GAMEPLAY: Battle saved in %.2f ms", (GetTime() - startTime) * 1000.0);
     }
 
-    if (teamUnitCount[0] == 0 || teamUnitCount[1] == 0)
+    UnlockBattleThread(battleThread);
+}
+
+void QuickLoadBattle(void)
+{
+    double startTime = GetTime();
+    Battle* threadBattle = LockBattleThread(battleThread);
+
+    if (LoadBattleState(threadBattle, QUICKSAVE_FILE_NAME, MAX_LOADED_CHUNKS) == false)
     {
-        finishScreen = 1;
+        UnlockBattleThread(battleThread);
+        return;
     }
 
+    // The replay only holds battles played from their spawns.
+    CloseReplayWriter(&replayWriter);
+
+    battleSeed = threadBattle->map.seed;
+    mapWidth = threadBattle->map.width;
+    mapHeight = threadBattle->map.height;
+
+    UnlockBattleThread(battleThread);
+
+    // The old map is gone, rebuild the view, the terrain and drop every tile pointer into it.
+    UnloadBattle(&battle);
+    LoadBattle(&battle, mapWidth, mapHeight, MAX_LOADED_CHUNKS, battleSeed);
+
+    battleFrameVersion = 0;
+    UpdateBattleView();
+
+    UnloadTerrain(&terrain);
+    LoadTerrain(&terrain, &battle.map);
+
+    hoverTile = NULL;
+    selection = -1;
+    numSelectionTiles = 0;
+
+    targetingMode = false;
+    attackTarget = ENTITY_NONE;
+    TextCopy(attackButton.text, "ATTACK");
+
+    TraceLog(LOG_INFO, "GAMEPLAY: Battle loaded in %.2f ms", (GetTime() - startTime) * 1000.0);
+
     BeginTurn();
 }
 
+// Set map size used by the next InitGameplayScreen() call
+void SetGameplayMapSize(int width, int height)
+{
+    mapWidth = width;
+    mapHeight = height;
+}
+
+// Set battle seed used by the next InitGameplayScreen() call, the same seed plays out the same
+// battle for the same actions. Without a seed every battle gets a random one.
+void SetGameplaySeed(unsigned int seed)
+{
+    battleSeed = seed;
+    isSeedSet = true;
+}
+
+// Let the AI play a team in the next InitGameplayScreen() call
+void SetGameplayAiTeam(int team, bool isAi)
+{
+    isAiTeam[team] = isAi;
+}
+
 // Gameplay Screen Initialization logic
 void InitGameplayScreen(void)
 {
     // TODO: Initialize GAMEPLAY screen variables here!
     framesCounter = 0;
     finishScreen = 0;
-    numEntities = 0;
-    numEntityTurns = 0;
 
     // Initialize Level
-    for (int z = 0; z < MAP_HEIGHT_VERTICES; z++)
-    {
-        for (int x = 0; x < MAP_WIDTH_VERTICES; x++)
-        {
-            depthMap[z][x] = GetRandomValue(-1, 1) / 5.0f;
-        }
-    }
+    if (isSeedSet == false) battleSeed = (unsigned int)GetRandomValue(0, 0x7fffffff);
+    TraceLog(LOG_INFO, "GAMEPLAY: Battle seed %u", battleSeed);
 
-    for (int z = 0; z < MAP_HEIGHT; z++)
-    {
-        for (int x = 0; x < MAP_WIDTH; x++)
-        {
-            Tile* tile = &tileMap[z][x];
+    LoadBattle(&simulationBattle, mapWidth, mapHeight, MAX_LOADED_CHUNKS, battleSeed);
+    LoadBattle(&battle, mapWidth, mapHeight, MAX_LOADED_CHUNKS, battleSeed);
 
-            tile->bottomLeft = (Vector3){ (float)x, depthMap[z][x], (float)z };
-            tile->bottomRight = (Vector3){ (float)x + TILE_SIZE, depthMap[z][x + 1], (float)z };
-            tile->topRight = (Vector3){ (float)x + TILE_SIZE, depthMap[z + 1][x + 1], (float)z + TILE_SIZE };
-            tile->topLeft = (Vector3){ (float)x, depthMap[z + 1][x], (float)z + TILE_SIZE };
+    // Generate the whole map up front on every core if it fits the chunk budget, larger maps
+    // are generated around the action as it moves.
+    if (battle.map.chunksX * battle.map.chunksZ <= MAX_LOADED_CHUNKS)
+    {
+        ThreadPool* terrainPool = LoadThreadPool(0);
 
-            tile->tileCenterPos.x = (tile->bottomLeft.x + tile->topRight.x) / 2;
-            tile->tileCenterPos.y = (tile->bottomLeft.z + tile->topRight.z) / 2;
+        LoadMapChunks(&simulationBattle.map, terrainPool, 0, 0, battle.map.chunksX - 1, battle.map.chunksZ - 1);
+        LoadMapChunks(&battle.map, terrainPool, 0, 0, battle.map.chunksX - 1, battle.map.chunksZ - 1);
 
-            tile->entityPos = (depthMap[z][x] + depthMap[z][x + 1] + depthMap[z + 1][x + 1] + depthMap[z + 1][x]) / 4;
-            tile->texture = grassTexture;
-            tile->entity = NULL;
-            tile->walkable = true;      // TODO: BASED ON BIOME
-        }
+        UnloadThreadPool(terrainPool);
     }
 
-    // TODO: FIX TEAM ID / SPAWN ID STUFF
-    // TODO: SELECT SPAWN TILE RANDOMLY INSTEAD OF ALL
-    for (int i = 0; i < SPAWN_ZONES; i++)
-    {
-        spawnZones[i].playerID = i;
-        spawnZones[i].numTiles = 8;
+    // Every battle is recorded, play it back with "simulator replay last_battle.replay".
+    if (OpenReplayWriter(&replayWriter, REPLAY_FILE_NAME, battleSeed, mapWidth, mapHeight)) simulationBattle.recorder = &replayWriter;
 
-        for (int j = 0; j < spawnZones[i].numTiles; j++)
-        {
-            spawnZones[i].tiles[j] = &tileMap[j][i * (MAP_WIDTH - 1)];
-        }
+    fontAsset = LoadAsset(assets, ASSET_FONT, FONT_FILE_NAME);
+    grassTextureAsset = LoadAsset(assets, ASSET_TEXTURE, GRASS_TEXTURE_FILE_NAME);
+
+    for (int i = 0; i < SPRITE_COUNT; i++)
+    {
+        spriteAssets[i] = GetAssetHandle(assets, ASSET_SPRITE, spriteFileNames[i]);
     }
 
+    LoadTerrain(&terrain, &battle.map);
+
     // Initialize and spawn Entities
 
-    SpawnTerrainObject(4, 3, &treeTexture);
-    SpawnTerrainObject(1, 5, &treeTexture);
-    SpawnTerrainObject(2, 2, &rockTexture);
+    SpawnTerrainObject(4, 3, SPRITE_TREE);
+    SpawnTerrainObject(1, 5, SPRITE_TREE);
+    SpawnTerrainObject(2, 2, SPRITE_ROCK);
+
+    SpawnCharacter(0, SPRITE_WIZARD, SPRITE_WIZARD_DEAD, &(UnitTemplate){ "Pasi", 4, 6, 80, 80, 6, 12 });
+    SpawnCharacter(0, SPRITE_WIZARD, SPRITE_WIZARD_DEAD, &(UnitTemplate){ "Kielo", 4, 6, 85, 85, 8, 14 });
+    SpawnCharacter(0, SPRITE_WIZARD, SPRITE_WIZARD_DEAD, &(UnitTemplate){ "Gandalf", 6, 4, 75, 75, 12, 22 });
 
-    SpawnCharacter(&spawnZones[0], &wizardTexture, &deadWizardTexture, 4, 6, 80, 80, 6, 12, "Pasi");
-    SpawnCharacter(&spawnZones[0], &wizardTexture, &deadWizardTexture, 4, 6, 85, 85, 8, 14, "Kielo");
-    SpawnCharacter(&spawnZones[0], &wizardTexture, &deadWizardTexture, 6, 4, 75, 75, 12, 22, "Gandalf");
-         
-    SpawnCharacter(&spawnZones[1], &orcTexture, &deadOrcTexture, 2, 10, 80, 120, 5, 15, "Siqu");
-    SpawnCharacter(&spawnZones[1], &orcTexture, &deadOrcTexture, 3, 10, 130, 130, 16, 20, "Bab");
-    SpawnCharacter(&spawnZones[1], &orcTexture, &deadOrcTexture, 3, 2, 100, 100, 14, 18, "Sukellushitsaaja");
+    SpawnCharacter(1, SPRITE_ORC, SPRITE_ORC_DEAD, &(UnitTemplate){ "Siqu", 2, 10, 80, 120, 5, 15 });
+    SpawnCharacter(1, SPRITE_ORC, SPRITE_ORC_DEAD, &(UnitTemplate){ "Bab", 3, 10, 130, 130, 16, 20 });
+    SpawnCharacter(1, SPRITE_ORC, SPRITE_ORC_DEAD, &(UnitTemplate){ "Sukellushitsaaja", 3, 2, 100, 100, 14, 18 });
 
     TextCopy(endTurnButton.text, "END TURN");
     endTurnButton.textColor = WHITE;
@@ -673,6 +771,14 @@ void InitGameplayScreen(void)
     attackButton.rect.y = GetScreenHeight() - attackButton.rect.height * 2;
     attackButton.fontSize = 32;
 
+    // From here on the battle belongs to the battle thread, this thread only draws its frames.
+    BeginBattle(&simulationBattle);
+    battleThread = LoadBattleThread(&simulationBattle, isAiTeam);
+
+    battleFrameVersion = 0;
+    numQueuedActions = 0;
+    isMoveQueued = false;
+    UpdateBattleView();
     BeginTurn();
 }
 
@@ -680,36 +786,50 @@ void InitGameplayScreen(void)
 void UpdateGameplayScreen(void)
 {
     UpdateGameCamera(&camera);
+    UpdateBattleView();
 
-    // Level variables
-    Vector3 bottomLeft = { 0.0f, 0.0f, 0.0f };
-    Vector3 bottomRight = { MAP_WIDTH, 0.0f, 0.0f };
-    Vector3 topLeft = { 0.0f, 0.0f, MAP_HEIGHT };
-    Vector3 topRight = { MAP_WIDTH, 0.0f, MAP_HEIGHT };
+    // Not while a unit walks, its action waits for the battle thread or the AI plays.
+    bool isTurnEnding = (movingEntity != ENTITY_NONE || battleFrame->numActions != numQueuedActions ||
+        (selection != -1 && isAiTeam[battle.entities.teamIDs[selection]]));
 
-    float boxSize = 1.0f;
-    float boxHeight = 0.05f;
+    if (isTurnEnding == false)
+    {
+        if (IsKeyPressed(KEY_F5)) QuickSaveBattle();
+        if (IsKeyPressed(KEY_F9)) QuickLoadBattle();
+    }
+
+    // Keep the map within its memory budget, chunks around the active unit stay loaded.
+    if (selection != -1) EvictMapChunks(&battle.map, GetEntityTile(&battle, selection)->x, GetEntityTile(&battle, selection)->z);
+    else EvictMapChunks(&battle.map, (int)camera.target.x, (int)camera.target.z);
 
+    // Pick the tile under the mouse on the actual terrain heights. Sprites stand up from their
+    // tile and hide what is behind them, a hit on one picks the tile it stands on.
     Ray mouseRay = GetMouseRay(GetMousePosition(), camera);
+    Tile* selectionTile = GetMapRayCollision(&battle.map, mouseRay, &hitMapWorld);
 
-    for (int i = 0; i < numEntities; i++)
+    RayCollision hitEntity = { 0 };
+    int pickedEntity = GetGridRayCollision(&battle.entityGrid, mouseRay, NULL, NULL, &hitEntity);
+
+    if (pickedEntity != ENTITY_NONE && (hitMapWorld.hit == false || hitEntity.distance < hitMapWorld.distance))
     {
-        Vector3 orcBoxMin = { entities[i].position.x, entities[i].position.y - boxHeight, entities[i].position.z };
-        Vector3 orcBoxMax = { entities[i].position.x + boxSize, entities[i].position.y, entities[i].position.z + boxSize };
-        entities[i].boundingBox = (BoundingBox){ orcBoxMin, orcBoxMax };
+        selectionTile = GetEntityTile(&battle, pickedEntity);
+        hitMapWorld = hitEntity;
     }
 
-    hitMapWorld = GetRayCollisionQuad(mouseRay, bottomLeft, topLeft, topRight, bottomRight);
-
-    float selectionRectX = floorf(hitMapWorld.point.x);
-    float selectionRectZ = floorf(hitMapWorld.point.z);
+    if (selectionTile != NULL)
+    {
+        selectionRectPos = (Vector3){ (float)selectionTile->x, selectionTile->entityPos, (float)selectionTile->z };
+    }
 
-    Tile* selectionTile = &tileMap[(int)selectionRectZ][(int)selectionRectX];
-    selectionRectPos = (Vector3){ selectionRectX, selectionTile->entityPos, selectionRectZ };
+    hoverTile = selectionTile;
 
-    if (IsButtonClicked(&endTurnButton))
+    if (isTurnEnding)
     {
-        EndTurn();
+        // Input waits until the turn is over.
+    }
+    else if (IsButtonClicked(&endTurnButton))
+    {
+        QueueAction((Action){ ACTION_WAIT, selection, -1, ENTITY_NONE });
     }
     else if (IsButtonClicked(&attackButton) && selection != -1)
     {
@@ -720,85 +840,105 @@ void UpdateGameplayScreen(void)
     {
         if (selection != -1)
         {
-            Entity* entity = &entities[selection];
+            int entity = selection;
 
             if (IsTileSelectable(selectionTile))
             {
                 // Entity movement
-                if (selectionTile->entity == NULL || (entity->target != NULL && selectionTile->entity == entity))
+                if (selectionTile->entity == ENTITY_NONE || (attackTarget != ENTITY_NONE && selectionTile->entity == entity))
                 {
-                    entity->position = selectionRectPos;
-                    Vector3 orcBoxMin = { entity->position.x, entity->position.y - boxHeight, entity->position.z };
-                    Vector3 orcBoxMax = { entity->position.x + boxSize, entity->position.y, entity->position.z + boxSize };
-                    entity->boundingBox = (BoundingBox){ orcBoxMin, orcBoxMax };
-
-                    entity->tile->entity = NULL;
-                    entity->tile = selectionTile;
-                    selectionTile->entity = entity;
+                    Action action = { ACTION_MOVEMENT, entity, GetMapTileIndex(&battle.map, selectionTile), ENTITY_NONE };
 
-                    // Attack
-                    if (entity->target != NULL)
+                    if (attackTarget != ENTITY_NONE)
                     {
-                        int damage = GetRandomValue(entity->minAttack, entity->maxAttack);
-                        entity->target->health = entity->target->health - damage;
+                        action.type = ACTION_ATTACK_BASIC;
+                        action.target = attackTarget;
+                    }
 
-                        if (entity->target->health <= 0)
-                        {
-                            entity->target->health = 0;
-                            KillEntity(entity->target);
-                        }
+                    if (IsActionValid(&battle, action))
+                    {
+                        BeginEntityMovement(action, FindPath(&battle.pathfinder, GetEntityTile(&battle, entity), selectionTile, battle.entities.infos[entity].speed));
                     }
-                    entity->target = NULL;
-                    EndTurn();
                 }
 
                 // Entity attack
-                else if (IsEnemy(selectionTile->entity) && selectionTile->entity->type == ENTITY_TYPE_CHARACTER)
+                else if (IsBattleTarget(&battle, entity, selectionTile->entity))
                 {
-                    //selectionTile->entity->isAlive = false;
+                    //KillBattleEntity(&battle, selectionTile->entity);
 
                     // Find tiles where we can hit the enemy.
-                    entity->target = selectionTile->entity;
-                    Vector3 enemyPos = selectionTile->entity->position;
+                    attackTarget = selectionTile->entity;
+                    Tile* attackTiles[9] = { 0 };
                     int numAttackTiles = 0;
 
-                    for (int i = 0; i < numSelectionTiles; i++)
+                    for (int z = selectionTile->z - 1; z <= selectionTile->z + 1; z++)
                     {
-                        float tileDistance = Vector2Distance((Vector2) { enemyPos.x + 0.5f, enemyPos.z + 0.5f }, selectionTiles[i]->tileCenterPos);
-
-                        if (tileDistance < 1.45f) // Replace with attack range?
+                        for (int x = selectionTile->x - 1; x <= selectionTile->x + 1; x++)
                         {
-                            selectionTiles[numAttackTiles] = selectionTiles[i];
-                            numAttackTiles++;
+                            Tile* tile = GetMapTile(&battle.map, x, z);
+
+                            if (tile && IsTileSelectable(tile)) // Replace with attack range?
+                            {
+                                attackTiles[numAttackTiles] = tile;
+                                numAttackTiles++;
+                            }
                         }
                     }
-                    numSelectionTiles = numAttackTiles;
+
+                    ClearSelectionTiles();
+
+                    for (int i = 0; i < numAttackTiles; i++)
+                    {
+                        AddSelectionTile(attackTiles[i]);
+                    }
                 }
             }
 
         }
     }
-    if (selection != -1)
+
+    // Debug keys, these bypass the battle rules and are not recorded to the replay.
+    if (selection != -1 && isTurnEnding == false && (IsKeyPressed(KEY_K) || IsKeyPressed(KEY_L)))
     {
-        if (IsKeyPressed(KEY_K)) RemoveEntity(&entities[selection]);
-        if (IsKeyPressed(KEY_L)) KillEntity(&entities[selection]);
+        Battle* threadBattle = LockBattleThread(battleThread);
+
+        if (IsKeyPressed(KEY_K)) RemoveBattleEntity(threadBattle, selection);
+        if (IsKeyPressed(KEY_L)) KillBattleEntity(threadBattle, selection);
+
+        UnlockBattleThread(battleThread);
     }
 }
 
 void DrawEntityTurnQueue()
 {
+    int x = 1700;
+    int y = 100;
     int index = 0;
 
-    for (int i = 0; i < numEntityTurns; i++)
+    // The active unit is out of the queue during its turn.
+    if (selection != -1)
     {
-        int x = 1700;
-        int y = 100;
+        DrawText(TextFormat("%d: %s [%d]", index + 1, battle.entities.infos[selection].name, 0), x, y + index * 30, 20, MAROON);
+        index++;
+    }
 
-        if (entityTurnQueue[i] != NULL && entityTurnQueue[i]->isAlive && entityTurnQueue[i]->type == ENTITY_TYPE_CHARACTER)
-        {
-            DrawText(TextFormat("%d: %s [%d]", index + 1, entityTurnQueue[i]->name, entityTurnQueue[i]->currentInitiative), x, y + index * 30, 20, MAROON);
-            index++;
-        }
+    TurnEntry* turnOrder = NULL;
+    int numTurns = GetTurnOrder(&battle.turnScheduler, &battle.entities, &turnOrder);
+
+    for (int i = 0; i < numTurns; i++)
+    {
+        DrawText(TextFormat("%d: %s [%d]", index + 1, battle.entities.infos[turnOrder[i].entity].name, turnOrder[i].time - battle.turnScheduler.time), x, y + index * 30, 20, MAROON);
+        index++;
+    }
+}
+
+// Gameplay Screen fixed update logic, runs FIXED_UPDATE_RATE times per second
+void FixedUpdateGameplayScreen(void)
+{
+    // Input only queues actions, the battle thread applies them.
+    if (movingEntity != ENTITY_NONE)
+    {
+        UpdateEntityMovement();
     }
 }
 
@@ -810,18 +950,24 @@ void DrawGameplayScreen(void)
 
     BeginMode3D(camera);
 
-        DrawTiles(&tileMap[0][0], MAP_HEIGHT, MAP_WIDTH, camera);
-        //DrawGameGrid(MAP_WIDTH, MAP_HEIGHT, 1);
+        UpdateTerrain(&terrain, &battle.map);
+        DrawTerrain(&terrain, GetAssetTexture(assets, grassTextureAsset));
+        //DrawGameGrid(map.width, map.height, 1);
 
         if (selection != -1)
         {
-            DrawSelectionArea(selectionTiles, numSelectionTiles, &entities[selection]);
+            DrawSelectionArea(&battle.entities, selectionTiles, numSelectionTiles, selection);
         }
 
-        if (hitMapWorld.hit)
+        if (selection != -1 && movingEntity == ENTITY_NONE && hoverTile != NULL && hoverTile->entity == ENTITY_NONE && IsTileSelectable(hoverTile))
+        {
+            DrawPath(&battle.map, FindPath(&battle.pathfinder, GetEntityTile(&battle, selection), hoverTile, battle.entities.infos[selection].speed));
+        }
+
+        if (hoverTile != NULL)
         {
             Color color = { WHITE.r, WHITE.g, WHITE.b, 96 };
-            Tile* tile = &tileMap[(int)selectionRectPos.z][(int)selectionRectPos.x];
+            Tile* tile = hoverTile;
 
             Vector3 bottomLeft = tile->bottomLeft;
             bottomLeft.y -= 0.02f;
@@ -835,7 +981,7 @@ void DrawGameplayScreen(void)
             DrawQuad3D(camera, bottomLeft, bottomRight, topRight, topLeft, color);
         }
 
-        DrawEntities(entities, numEntities, selection, camera);
+        DrawEntities(&battle.entities, selection, movingEntity, Vector3Lerp(previousMovePosition, movePosition, updateAlpha), camera, &renderSorter, &billboardBatch);
         
     EndMode3D();
 
@@ -849,6 +995,7 @@ void DrawGameplayScreen(void)
     DrawEntityTurnQueue();
 
     Vector2 pos = { 20, 10 };
+    Font font = GetAssetFont(assets, fontAsset);
     DrawTextEx(font, "GAMEPLAY SCREEN", pos, font.baseSize * 3.0f, 4, MAROON);
    
     DrawButton(&endTurnButton);
@@ -858,11 +1005,32 @@ void DrawGameplayScreen(void)
 // Gameplay Screen Unload logic
 void UnloadGameplayScreen(void)
 {
-    for (int i = 0; i < MAX_ENTITIES; i++)
-    {
-        entities[i] = (Entity){ 0 };
-        entityTurnQueue[i] = NULL;
-    }
+    UnloadBattleThread(battleThread);
+    battleThread = NULL;
+    battleFrame = NULL;
+
+    UnloadTerrain(&terrain);
+    UnloadAsset(assets, fontAsset);
+    UnloadAsset(assets, grassTextureAsset);
+    CloseReplayWriter(&replayWriter);
+    UnloadBattle(&simulationBattle);
+    UnloadBattle(&battle);
+
+    MemFree(movePath);
+    movePath = NULL;
+    numMovePathTiles = 0;
+    maxMovePathTiles = 0;
+    movingEntity = ENTITY_NONE;
+
+    MemFree(selectionTiles);
+    selectionTiles = NULL;
+    numSelectionTiles = 0;
+    maxSelectionTiles = 0;
+    hoverTile = NULL;
+
+    attackTarget = ENTITY_NONE;
+
+    UnloadDepthSorter(&renderSorter);
 }
 
 // Gameplay Screen should finish?
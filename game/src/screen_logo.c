@@ -46,6 +46,8 @@ static int rightSideRecHeight = 0;
 static int state = 0;              // Logo animation states
 static float alpha = 1.0f;         // Useful for fading
 
+static float loadProgress = 0.0f;  // Share of the global assets loaded, the screen finishes once all are
+
 //----------------------------------------------------------------------------------
 // Logo Screen Functions Definition
 //----------------------------------------------------------------------------------
@@ -67,6 +69,8 @@ void InitLogoScreen(void)
 
     state = 0;
     alpha = 1.0f;
+
+    loadProgress = 0.0f;
 }
 
 // Logo Screen Update logic
@@ -114,14 +118,15 @@ void UpdateLogoScreen(void)
             {
                 alpha -= 0.02f;
 
-                if (alpha <= 0.0f)
-                {
-                    alpha = 0.0f;
-                    finishScreen = 1;   // Jump to next screen
-                }
+                if (alpha <= 0.0f) alpha = 0.0f;
             }
         }
     }
+
+    // Jump to next screen as soon as the assets are loaded, the animation is only there to watch meanwhile
+    loadProgress = GetAssetLoadProgress(assets);
+
+    if (loadProgress >= 1.0f) finishScreen = 1;
 }
 
 // Logo Screen Draw logic
@@ -158,6 +163,11 @@ void DrawLogoScreen(void)
 
         if (framesCounter > 20) DrawText("powered by", logoPositionX, logoPositionY - 27, 20, Fade(DARKGRAY, alpha));
     }
+
+    // Loading bar under the logo
+    DrawRectangleLines(logoPositionX, logoPositionY + 296, 256, 12, DARKGRAY);
+    DrawRectangle(logoPositionX + 2, logoPositionY + 298, (int)(252*loadProgress), 8, DARKGRAY);
+    DrawText("LOADING", logoPositionX, logoPositionY + 316, 10, DARKGRAY);
 }
 
 // Logo Screen Unload logic
@@ -32,6 +32,9 @@
 static int framesCounter = 0;
 static int finishScreen = 0;
 
+static AssetHandle fontAsset = ASSET_NONE;
+static AssetHandle fxCoinAsset = ASSET_NONE;
+
 //----------------------------------------------------------------------------------
 // Title Screen Functions Definition
 //----------------------------------------------------------------------------------
@@ -42,6 +45,9 @@ void InitTitleScreen(void)
     // TODO: Initialize TITLE screen variables here!
     framesCounter = 0;
     finishScreen = 0;
+
+    fontAsset = LoadAsset(assets, ASSET_FONT, FONT_FILE_NAME);
+    fxCoinAsset = LoadAsset(assets, ASSET_SOUND, COIN_SOUND_FILE_NAME);
 }
 
 // Title Screen Update logic
@@ -54,7 +60,7 @@ void UpdateTitleScreen(void)
     {
         //finishScreen = 1;   // OPTIONS
         finishScreen = 2;   // GAMEPLAY
-        PlaySound(fxCoin);
+        PlaySound(GetAssetSound(assets, fxCoinAsset));
     }
 }
 
@@ -64,6 +70,7 @@ void DrawTitleScreen(void)
     // TODO: Draw TITLE screen here!
     DrawRectangle(0, 0, GetScreenWidth(), GetScreenHeight(), GREEN);
     Vector2 pos = { 20, 10 };
+    Font font = GetAssetFont(assets, fontAsset);
     DrawTextEx(font, "TITLE SCREEN", pos, font.baseSize*3.0f, 4, DARKGREEN);
     DrawText("PRESS ENTER or TAP to JUMP to GAMEPLAY SCREEN", 120, 220, 20, DARKGREEN);
 }
@@ -72,6 +79,8 @@ void DrawTitleScreen(void)
 void UnloadTitleScreen(void)
 {
     // TODO: Unload TITLE screen variables here!
+    UnloadAsset(assets, fontAsset);
+    UnloadAsset(assets, fxCoinAsset);
 }
 
 // Title Screen should finish?
@@ -26,27 +26,29 @@
 #ifndef SCREENS_H
 #define SCREENS_H
 
+#include "assets.h"
+
 //----------------------------------------------------------------------------------
 // Types and Structures Definition
 //----------------------------------------------------------------------------------
+#define FIXED_UPDATE_RATE 60                // Fixed updates per second, game time never depends on the frame rate
+#define FIXED_TIME_STEP (1.0f/FIXED_UPDATE_RATE)
+
+// Assets shared by several screens, each screen loads what it uses by these names
+#define FONT_FILE_NAME "resources/mecha.png"
+#define MUSIC_FILE_NAME "resources/ambient.ogg"
+#define COIN_SOUND_FILE_NAME "resources/coin.wav"
+#define GRASS_TEXTURE_FILE_NAME "resources/grass.png"
+
 typedef enum GameScreen { UNKNOWN = -1, LOGO = 0, TITLE, OPTIONS, GAMEPLAY, ENDING } GameScreen;
 
 //----------------------------------------------------------------------------------
 // Global Variables Declaration (shared by several modules)
 //----------------------------------------------------------------------------------
 extern GameScreen currentScreen;
-extern Font font;
-extern Music music;
-extern Sound fxCoin;
-extern Texture2D grassTexture;
-extern Texture2D treeTexture;
-extern Texture2D rockTexture;
-extern Texture2D orcTexture;
-extern Texture2D deadOrcTexture;
-extern Texture2D wizardTexture;
-extern Texture2D deadWizardTexture;
-extern Texture2D blankTexture;
+extern AssetManager* assets;
 extern Camera3D camera;
+extern float updateAlpha;       // Time since the last fixed update as a fraction of FIXED_TIME_STEP
 
 #ifdef __cplusplus
 extern "C" {            // Prevents name mangling of functions
@@ -84,9 +86,13 @@ int FinishOptionsScreen(void);
 //----------------------------------------------------------------------------------
 void InitGameplayScreen(void);
 void UpdateGameplayScreen(void);
+void FixedUpdateGameplayScreen(void);
 void DrawGameplayScreen(void);
 void UnloadGameplayScreen(void);
 int FinishGameplayScreen(void);
+void SetGameplayMapSize(int width, int height);
+void SetGameplaySeed(unsigned int seed);
+void SetGameplayAiTeam(int team, bool isAi);
 
 //----------------------------------------------------------------------------------
 // Ending Screen Functions Declaration
@@ -0,0 +1,189 @@
+/**********************************************************************************************
+*
+*   Terrain - Static tile map meshes
+*
+*   Every tile becomes two triangles in the mesh of its map chunk, so the map is submitted
+*   with one draw call per chunk instead of one immediate-mode quad per tile and frame.
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "rlgl.h"
+#include "raymath.h"
+
+#include "terrain.h"
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+#define TERRAIN_VERTICES_PER_TILE 6
+
+// Mesh vertex buffer indices, see UploadMesh()
+#define TERRAIN_BUFFER_POSITIONS 0
+#define TERRAIN_BUFFER_TEXCOORDS 1
+#define TERRAIN_BUFFER_COLORS 3
+
+// Tints of the terrain texture, every other tile is a bit darker so the grid stays visible.
+static const Color biomeColors[BIOME_COUNT] = {
+    [BIOME_WATER] = { 70, 110, 200, 255 },
+    [BIOME_SAND] = { 235, 220, 160, 255 },
+    [BIOME_GRASS] = { 255, 255, 255, 255 },
+    [BIOME_FOREST] = { 120, 170, 110, 255 },
+    [BIOME_ROCK] = { 160, 150, 140, 255 },
+};
+
+//----------------------------------------------------------------------------------
+// Terrain Functions Definition
+//----------------------------------------------------------------------------------
+static void SetTerrainVertex(Mesh* mesh, int vertex, Vector3 position, float u, float v, Color color)
+{
+    mesh->vertices[vertex * 3 + 0] = position.x;
+    mesh->vertices[vertex * 3 + 1] = position.y;
+    mesh->vertices[vertex * 3 + 2] = position.z;
+
+    mesh->texcoords[vertex * 2 + 0] = u;
+    mesh->texcoords[vertex * 2 + 1] = v;
+
+    mesh->colors[vertex * 4 + 0] = color.r;
+    mesh->colors[vertex * 4 + 1] = color.g;
+    mesh->colors[vertex * 4 + 2] = color.b;
+    mesh->colors[vertex * 4 + 3] = color.a;
+}
+
+// Fill CPU side vertex data from the chunk tiles. Winding matches DrawQuad3D().
+static void BuildTerrainVertices(Mesh* mesh, MapChunk* chunk)
+{
+    int vertex = 0;
+
+    for (int localZ = 0; localZ < chunk->height; localZ++)
+    {
+        for (int localX = 0; localX < chunk->width; localX++)
+        {
+            Tile* tile = &chunk->tiles[localZ * CHUNK_SIZE + localX];
+            Color color = biomeColors[tile->biome];
+
+            if ((tile->x + tile->z) % 2)
+            {
+                color.r = (unsigned char)(color.r * 9 / 10);
+                color.g = (unsigned char)(color.g * 9 / 10);
+                color.b = (unsigned char)(color.b * 9 / 10);
+            }
+
+            SetTerrainVertex(mesh, vertex + 0, tile->topLeft, 0.0f, 0.0f, color);
+            SetTerrainVertex(mesh, vertex + 1, tile->bottomLeft, 0.0f, 1.0f, color);
+            SetTerrainVertex(mesh, vertex + 2, tile->bottomRight, 1.0f, 1.0f, color);
+
+            SetTerrainVertex(mesh, vertex + 3, tile->topLeft, 0.0f, 0.0f, color);
+            SetTerrainVertex(mesh, vertex + 4, tile->bottomRight, 1.0f, 1.0f, color);
+            SetTerrainVertex(mesh, vertex + 5, tile->topRight, 1.0f, 0.0f, color);
+
+            vertex += TERRAIN_VERTICES_PER_TILE;
+        }
+    }
+}
+
+static void LoadTerrainChunk(TerrainChunk* terrainChunk, MapChunk* chunk)
+{
+    int numTiles = chunk->width * chunk->height;
+    Mesh* mesh = &terrainChunk->mesh;
+
+    *mesh = (Mesh){ 0 };
+    mesh->vertexCount = numTiles * TERRAIN_VERTICES_PER_TILE;
+    mesh->triangleCount = numTiles * 2;
+    mesh->vertices = (float*)MemAlloc(mesh->vertexCount * 3 * sizeof(float));
+    mesh->texcoords = (float*)MemAlloc(mesh->vertexCount * 2 * sizeof(float));
+    mesh->colors = (unsigned char*)MemAlloc(mesh->vertexCount * 4 * sizeof(unsigned char));
+
+    BuildTerrainVertices(mesh, chunk);
+
+    // Dynamic buffers, tiles may still change after the initial upload.
+    UploadMesh(mesh, true);
+
+    terrainChunk->isLoaded = true;
+    terrainChunk->revision = chunk->revision;
+}
+
+static void UnloadTerrainChunk(TerrainChunk* terrainChunk)
+{
+    UnloadMesh(terrainChunk->mesh);
+    *terrainChunk = (TerrainChunk){ 0 };
+}
+
+void LoadTerrain(Terrain* terrain, Map* map)
+{
+    terrain->chunksX = map->chunksX;
+    terrain->chunksZ = map->chunksZ;
+    terrain->chunks = (TerrainChunk*)MemAlloc(map->chunksX * map->chunksZ * sizeof(TerrainChunk));
+
+    terrain->material = LoadMaterialDefault();
+
+    UpdateTerrain(terrain, map);
+}
+
+// Follow map chunk loads and evictions. Only chunks whose revision changed
+// since the last call are touched.
+void UpdateTerrain(Terrain* terrain, Map* map)
+{
+    for (int i = 0; i < terrain->chunksX * terrain->chunksZ; i++)
+    {
+        TerrainChunk* terrainChunk = &terrain->chunks[i];
+        MapChunk* chunk = &map->chunks[i];
+
+        if (terrainChunk->isLoaded && terrainChunk->revision == chunk->revision)
+        {
+            continue;
+        }
+
+        if (chunk->tiles == NULL)
+        {
+            if (terrainChunk->isLoaded) UnloadTerrainChunk(terrainChunk);
+        }
+        else if (terrainChunk->isLoaded == false)
+        {
+            LoadTerrainChunk(terrainChunk, chunk);
+        }
+        else
+        {
+            Mesh* mesh = &terrainChunk->mesh;
+
+            BuildTerrainVertices(mesh, chunk);
+
+            UpdateMeshBuffer(*mesh, TERRAIN_BUFFER_POSITIONS, mesh->vertices, mesh->vertexCount * 3 * sizeof(float), 0);
+            UpdateMeshBuffer(*mesh, TERRAIN_BUFFER_TEXCOORDS, mesh->texcoords, mesh->vertexCount * 2 * sizeof(float), 0);
+            UpdateMeshBuffer(*mesh, TERRAIN_BUFFER_COLORS, mesh->colors, mesh->vertexCount * 4 * sizeof(unsigned char), 0);
+
+            terrainChunk->revision = chunk->revision;
+        }
+    }
+}
+
+// The texture is given on every draw, it may be reloaded meanwhile. Until it is loaded the
+// terrain is drawn in its tile colours only.
+void DrawTerrain(Terrain* terrain, Texture2D texture)
+{
+    terrain->material.maps[MATERIAL_MAP_DIFFUSE].texture.id = (texture.id != 0) ? texture.id : rlGetTextureIdDefault();
+
+    for (int i = 0; i < terrain->chunksX * terrain->chunksZ; i++)
+    {
+        if (terrain->chunks[i].isLoaded)
+        {
+            DrawMesh(terrain->chunks[i].mesh, terrain->material, MatrixIdentity());
+        }
+    }
+}
+
+void UnloadTerrain(Terrain* terrain)
+{
+    for (int i = 0; i < terrain->chunksX * terrain->chunksZ; i++)
+    {
+        if (terrain->chunks[i].isLoaded) UnloadTerrainChunk(&terrain->chunks[i]);
+    }
+
+    MemFree(terrain->chunks);
+
+    // The texture is shared with the rest of the game, don't let UnloadMaterial() free it.
+    terrain->material.maps[MATERIAL_MAP_DIFFUSE].texture.id = rlGetTextureIdDefault();
+    UnloadMaterial(terrain->material);
+
+    *terrain = (Terrain){ 0 };
+}
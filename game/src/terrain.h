@@ -0,0 +1,33 @@
+#ifndef TERRAIN_H
+#define TERRAIN_H
+
+#include "raylib.h"
+#include "level.h"
+
+// Terrain geometry of one map chunk, kept in a static GPU mesh.
+typedef struct TerrainChunk
+{
+	Mesh mesh;
+	bool isLoaded;
+	unsigned int revision;		// MapChunk revision the mesh was built from.
+
+} TerrainChunk;
+
+// Terrain geometry for a whole map, one mesh and one draw call per loaded chunk.
+// Meshes are only rebuilt and re-uploaded when the chunk revision changes.
+typedef struct Terrain
+{
+	TerrainChunk* chunks;
+	Material material;
+
+	int chunksX;
+	int chunksZ;
+
+} Terrain;
+
+void LoadTerrain(Terrain* terrain, Map* map);
+void UpdateTerrain(Terrain* terrain, Map* map);
+void DrawTerrain(Terrain* terrain, Texture2D texture);
+void UnloadTerrain(Terrain* terrain);
+
+#endif
@@ -0,0 +1,270 @@
+/**********************************************************************************************
+*
+*   Thread Pool - Work stealing parallel for
+*
+*   Tasks are split evenly between the workers up front. A worker that runs out steals half
+*   of the remaining tasks of another worker, so uneven task lengths still keep every core
+*   busy. The calling thread works as worker 0.
+*
+**********************************************************************************************/
+
+#include "thread_pool.h"
+#include "threads.h"
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+#define CACHE_LINE_SIZE 64
+
+// Tasks [begin, end) not yet taken. Padded so queues of different workers don't share a
+// cache line.
+typedef struct TaskQueue
+{
+    Mutex lock;
+    int begin;
+    int end;
+    char padding[CACHE_LINE_SIZE];
+} TaskQueue;
+
+typedef struct Worker
+{
+    ThreadPool* pool;
+    Thread thread;
+    int index;
+} Worker;
+
+struct ThreadPool
+{
+    Worker* workers;
+    TaskQueue* queues;
+    int numWorkers;
+
+    Mutex lock;
+    Condition workReady;
+    Condition workDone;
+    unsigned int generation;        // Incremented for every RunParallelFor() call.
+    int numBusyWorkers;
+    bool isQuitting;
+
+    TaskFunction function;
+    void* data;
+};
+
+//----------------------------------------------------------------------------------
+// Thread Pool Functions Definition
+//----------------------------------------------------------------------------------
+static bool PopTask(ThreadPool* pool, int worker, int* task)
+{
+    TaskQueue* queue = &pool->queues[worker];
+    bool isFound = false;
+
+    LockMutex(&queue->lock);
+
+    if (queue->begin < queue->end)
+    {
+        *task = queue->begin;
+        queue->begin++;
+        isFound = true;
+    }
+
+    UnlockMutex(&queue->lock);
+
+    return isFound;
+}
+
+// Move half of the tasks left in another queue to the worker's own, empty queue. Takes from
+// the end, the owner keeps popping from the front.
+static bool StealTasks(ThreadPool* pool, int worker)
+{
+    for (int i = 1; i < pool->numWorkers; i++)
+    {
+        TaskQueue* victim = &pool->queues[(worker + i) % pool->numWorkers];
+
+        LockMutex(&victim->lock);
+
+        int numTasks = victim->end - victim->begin;
+
+        if (numTasks <= 0)
+        {
+            UnlockMutex(&victim->lock);
+            continue;
+        }
+
+        int end = victim->end;
+        int begin = end - (numTasks + 1) / 2;
+        victim->end = begin;
+
+        UnlockMutex(&victim->lock);
+
+        TaskQueue* queue = &pool->queues[worker];
+
+        LockMutex(&queue->lock);
+        queue->begin = begin;
+        queue->end = end;
+        UnlockMutex(&queue->lock);
+
+        return true;
+    }
+
+    return false;
+}
+
+static void RunTasks(ThreadPool* pool, int worker)
+{
+    int task = 0;
+
+    do
+    {
+        while (PopTask(pool, worker, &task))
+        {
+            pool->function(pool->data, task, worker);
+        }
+    }
+    while (StealTasks(pool, worker));
+}
+
+static void RunWorker(void* data)
+{
+    Worker* worker = (Worker*)data;
+    ThreadPool* pool = worker->pool;
+    unsigned int generation = 0;
+
+    LockMutex(&pool->lock);
+
+    while (true)
+    {
+        while (pool->isQuitting == false && pool->generation == generation)
+        {
+            WaitCondition(&pool->workReady, &pool->lock);
+        }
+
+        if (pool->isQuitting)
+        {
+            break;
+        }
+
+        generation = pool->generation;
+        UnlockMutex(&pool->lock);
+
+        RunTasks(pool, worker->index);
+
+        LockMutex(&pool->lock);
+        pool->numBusyWorkers--;
+
+        if (pool->numBusyWorkers == 0)
+        {
+            SignalCondition(&pool->workDone);
+        }
+    }
+
+    UnlockMutex(&pool->lock);
+}
+
+// Start the worker threads, numWorkers <= 0 uses one worker per processor. The calling
+// thread counts as a worker.
+ThreadPool* LoadThreadPool(int numWorkers)
+{
+    if (numWorkers <= 0)
+    {
+        numWorkers = GetProcessorCount();
+    }
+
+    ThreadPool* pool = (ThreadPool*)calloc(1, sizeof(ThreadPool));
+
+    pool->numWorkers = numWorkers;
+    pool->workers = (Worker*)calloc(numWorkers, sizeof(Worker));
+    pool->queues = (TaskQueue*)calloc(numWorkers, sizeof(TaskQueue));
+
+    InitMutex(&pool->lock);
+    InitCondition(&pool->workReady);
+    InitCondition(&pool->workDone);
+
+    for (int i = 0; i < numWorkers; i++)
+    {
+        InitMutex(&pool->queues[i].lock);
+
+        pool->workers[i].pool = pool;
+        pool->workers[i].index = i;
+    }
+
+    for (int i = 1; i < numWorkers; i++)
+    {
+        StartThread(&pool->workers[i].thread, RunWorker, &pool->workers[i]);
+    }
+
+    return pool;
+}
+
+void UnloadThreadPool(ThreadPool* pool)
+{
+    if (pool == NULL)
+    {
+        return;
+    }
+
+    LockMutex(&pool->lock);
+    pool->isQuitting = true;
+    BroadcastCondition(&pool->workReady);
+    UnlockMutex(&pool->lock);
+
+    for (int i = 1; i < pool->numWorkers; i++)
+    {
+        JoinThread(&pool->workers[i].thread);
+    }
+
+    for (int i = 0; i < pool->numWorkers; i++)
+    {
+        DestroyMutex(&pool->queues[i].lock);
+    }
+
+    DestroyCondition(&pool->workDone);
+    DestroyCondition(&pool->workReady);
+    DestroyMutex(&pool->lock);
+
+    free(pool->queues);
+    free(pool->workers);
+    free(pool);
+}
+
+int GetThreadPoolWorkers(ThreadPool* pool)
+{
+    return pool->numWorkers;
+}
+
+// Run function for every task in [0, numTasks) and wait until all of them are done. Call from
+// one thread at a time, and not from inside a task.
+void RunParallelFor(ThreadPool* pool, int numTasks, TaskFunction function, void* data)
+{
+    if (numTasks <= 0)
+    {
+        return;
+    }
+
+    for (int i = 0; i < pool->numWorkers; i++)
+    {
+        pool->queues[i].begin = (int)((long long)numTasks * i / pool->numWorkers);
+        pool->queues[i].end = (int)((long long)numTasks * (i + 1) / pool->numWorkers);
+    }
+
+    LockMutex(&pool->lock);
+    pool->function = function;
+    pool->data = data;
+    pool->numBusyWorkers = pool->numWorkers - 1;
+    pool->generation++;
+    BroadcastCondition(&pool->workReady);
+    UnlockMutex(&pool->lock);
+
+    RunTasks(pool, 0);
+
+    LockMutex(&pool->lock);
+
+    while (pool->numBusyWorkers > 0)
+    {
+        WaitCondition(&pool->workDone, &pool->lock);
+    }
+
+    UnlockMutex(&pool->lock);
+}
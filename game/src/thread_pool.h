@@ -0,0 +1,19 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+// Called once for every task index. Tasks running at the same time always have different
+// worker indices, so per worker data can be used without locking.
+typedef void (*TaskFunction)(void* data, int taskIndex, int workerIndex);
+
+// Fixed set of worker threads running parallel for loops. Platform threads are kept out of
+// the header, it doesn't include raylib.h either so windows.h can't collide with it.
+typedef struct ThreadPool ThreadPool;
+
+ThreadPool* LoadThreadPool(int numWorkers);
+void UnloadThreadPool(ThreadPool* pool);
+
+int GetThreadPoolWorkers(ThreadPool* pool);
+
+void RunParallelFor(ThreadPool* pool, int numTasks, TaskFunction function, void* data);
+
+#endif
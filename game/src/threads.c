@@ -0,0 +1,164 @@
+/**********************************************************************************************
+*
+*   Threads - Platform threads, locks, atomics and clock
+*
+*   Thin wrappers over the Win32 API and pthreads, so the modules running work on other
+*   threads share one platform layer. Doesn't use raylib, the thread pool must not need it.
+*
+**********************************************************************************************/
+
+// clock_gettime() is hidden by -std=c99 unless POSIX features are asked for.
+#if !defined(_WIN32) && !defined(_DEFAULT_SOURCE)
+    #define _DEFAULT_SOURCE
+#endif
+
+#include "threads.h"
+
+#include <stdlib.h>
+
+#if !defined(_WIN32)
+    #include <unistd.h>
+    #include <time.h>
+#endif
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+// Handed to the new thread, which frees it.
+typedef struct ThreadStart
+{
+    ThreadFunction function;
+    void* data;
+} ThreadStart;
+
+//----------------------------------------------------------------------------------
+// Threads Functions Definition
+//----------------------------------------------------------------------------------
+#if defined(_WIN32)
+static DWORD WINAPI ThreadMain(LPVOID argument)
+{
+    ThreadStart start = *(ThreadStart*)argument;
+
+    free(argument);
+    start.function(start.data);
+
+    return 0;
+}
+
+bool StartThread(Thread* thread, ThreadFunction function, void* data)
+{
+    ThreadStart* start = (ThreadStart*)malloc(sizeof(ThreadStart));
+    start->function = function;
+    start->data = data;
+
+    *thread = CreateThread(NULL, 0, ThreadMain, start, 0, NULL);
+
+    if (*thread == NULL)
+    {
+        free(start);
+        return false;
+    }
+
+    return true;
+}
+
+void JoinThread(Thread* thread)
+{
+    WaitForSingleObject(*thread, INFINITE);
+    CloseHandle(*thread);
+}
+
+int GetProcessorCount(void)
+{
+    SYSTEM_INFO info = { 0 };
+    GetSystemInfo(&info);
+
+    return (int)info.dwNumberOfProcessors;
+}
+
+void InitMutex(Mutex* mutex) { InitializeCriticalSection(mutex); }
+void DestroyMutex(Mutex* mutex) { DeleteCriticalSection(mutex); }
+void LockMutex(Mutex* mutex) { EnterCriticalSection(mutex); }
+void UnlockMutex(Mutex* mutex) { LeaveCriticalSection(mutex); }
+
+void InitCondition(Condition* condition) { InitializeConditionVariable(condition); }
+void DestroyCondition(Condition* condition) { (void)condition; }
+void WaitCondition(Condition* condition, Mutex* mutex) { SleepConditionVariableCS(condition, mutex, INFINITE); }
+void SignalCondition(Condition* condition) { WakeConditionVariable(condition); }
+void BroadcastCondition(Condition* condition) { WakeAllConditionVariable(condition); }
+
+long LoadAtomic(volatile long* value) { return InterlockedCompareExchange(value, 0, 0); }
+void StoreAtomic(volatile long* value, long newValue) { InterlockedExchange(value, newValue); }
+long ExchangeAtomic(volatile long* value, long newValue) { return InterlockedExchange(value, newValue); }
+
+double GetMonotonicTime(void)
+{
+    LARGE_INTEGER frequency = { 0 };
+    LARGE_INTEGER counter = { 0 };
+
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+}
+#else
+static void* ThreadMain(void* argument)
+{
+    ThreadStart start = *(ThreadStart*)argument;
+
+    free(argument);
+    start.function(start.data);
+
+    return NULL;
+}
+
+bool StartThread(Thread* thread, ThreadFunction function, void* data)
+{
+    ThreadStart* start = (ThreadStart*)malloc(sizeof(ThreadStart));
+    start->function = function;
+    start->data = data;
+
+    if (pthread_create(thread, NULL, ThreadMain, start) != 0)
+    {
+        free(start);
+        return false;
+    }
+
+    return true;
+}
+
+void JoinThread(Thread* thread)
+{
+    pthread_join(*thread, NULL);
+}
+
+int GetProcessorCount(void)
+{
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return (count > 0) ? (int)count : 1;
+}
+
+void InitMutex(Mutex* mutex) { pthread_mutex_init(mutex, NULL); }
+void DestroyMutex(Mutex* mutex) { pthread_mutex_destroy(mutex); }
+void LockMutex(Mutex* mutex) { pthread_mutex_lock(mutex); }
+void UnlockMutex(Mutex* mutex) { pthread_mutex_unlock(mutex); }
+
+void InitCondition(Condition* condition) { pthread_cond_init(condition, NULL); }
+void DestroyCondition(Condition* condition) { pthread_cond_destroy(condition); }
+void WaitCondition(Condition* condition, Mutex* mutex) { pthread_cond_wait(condition, mutex); }
+void SignalCondition(Condition* condition) { pthread_cond_signal(condition); }
+void BroadcastCondition(Condition* condition) { pthread_cond_broadcast(condition); }
+
+long LoadAtomic(volatile long* value) { return __atomic_load_n(value, __ATOMIC_ACQUIRE); }
+void StoreAtomic(volatile long* value, long newValue) { __atomic_store_n(value, newValue, __ATOMIC_RELEASE); }
+long ExchangeAtomic(volatile long* value, long newValue) { return __atomic_exchange_n(value, newValue, __ATOMIC_ACQ_REL); }
+
+double GetMonotonicTime(void)
+{
+    struct timespec time = { 0 };
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return (double)time.tv_sec + (double)time.tv_nsec / 1000000000.0;
+}
+#endif
@@ -0,0 +1,53 @@
+#ifndef THREADS_H
+#define THREADS_H
+
+#include <stdbool.h>
+
+// Platform types are part of the header so locks can live inside other structs, include it
+// from source files only.
+#if defined(_WIN32)
+	// Keep windows.h from declaring what raylib.h already does.
+	#define WIN32_LEAN_AND_MEAN
+	#define NOGDI
+	#define NOUSER
+	#include <windows.h>
+
+	typedef HANDLE Thread;
+	typedef CRITICAL_SECTION Mutex;
+	typedef CONDITION_VARIABLE Condition;
+#else
+	#include <pthread.h>
+
+	typedef pthread_t Thread;
+	typedef pthread_mutex_t Mutex;
+	typedef pthread_cond_t Condition;
+#endif
+
+typedef void (*ThreadFunction)(void* data);
+
+bool StartThread(Thread* thread, ThreadFunction function, void* data);
+void JoinThread(Thread* thread);
+int GetProcessorCount(void);
+
+void InitMutex(Mutex* mutex);
+void DestroyMutex(Mutex* mutex);
+void LockMutex(Mutex* mutex);
+void UnlockMutex(Mutex* mutex);
+
+void InitCondition(Condition* condition);
+void DestroyCondition(Condition* condition);
+void WaitCondition(Condition* condition, Mutex* mutex);
+void SignalCondition(Condition* condition);
+void BroadcastCondition(Condition* condition);
+
+// Loads acquire, stores and exchanges release, so data written before a store is visible
+// to the thread that loads the value.
+long LoadAtomic(volatile long* value);
+void StoreAtomic(volatile long* value, long newValue);
+long ExchangeAtomic(volatile long* value, long newValue);
+
+// Seconds from an arbitrary start, never jumps with the system clock. Unlike clock() it
+// doesn't add up the time of every thread.
+double GetMonotonicTime(void);
+
+#endif
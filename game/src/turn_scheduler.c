@@ -0,0 +1,174 @@
+/**********************************************************************************************
+*
+*   Turn Scheduler - Initiative turn order
+*
+*   A unit acting at time T with base initiative I gets its next turn at T + I. Insert and
+*   pop are O(log n). Dead units are not removed eagerly, they are skipped when popped.
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+
+#include "turn_scheduler.h"
+
+//----------------------------------------------------------------------------------
+// Turn Scheduler Functions Definition
+//----------------------------------------------------------------------------------
+static bool IsTurnBefore(TurnEntry* a, TurnEntry* b)
+{
+    return (a->time < b->time) || (a->time == b->time && a->order < b->order);
+}
+
+static void SwapTurnEntries(TurnEntry* a, TurnEntry* b)
+{
+    TurnEntry temp = *a;
+    *a = *b;
+    *b = temp;
+}
+
+static void SiftTurnDown(TurnEntry* entries, int numEntries, int index)
+{
+    while (true)
+    {
+        int left = index * 2 + 1;
+        int right = left + 1;
+        int first = index;
+
+        if (left < numEntries && IsTurnBefore(&entries[left], &entries[first])) first = left;
+        if (right < numEntries && IsTurnBefore(&entries[right], &entries[first])) first = right;
+
+        if (first == index)
+        {
+            break;
+        }
+
+        SwapTurnEntries(&entries[index], &entries[first]);
+        index = first;
+    }
+}
+
+void UnloadTurnScheduler(TurnScheduler* scheduler)
+{
+    MemFree(scheduler->entries);
+    MemFree(scheduler->sortedEntries);
+
+    *scheduler = (TurnScheduler){ 0 };
+}
+
+// Make destination wait for the same turns as source.
+void CopyTurnScheduler(TurnScheduler* destination, const TurnScheduler* source)
+{
+    if (destination->maxEntries < source->numEntries)
+    {
+        destination->maxEntries = source->numEntries;
+        destination->entries = (TurnEntry*)MemRealloc(destination->entries, destination->maxEntries * sizeof(TurnEntry));
+    }
+
+    for (int i = 0; i < source->numEntries; i++)
+    {
+        destination->entries[i] = source->entries[i];
+    }
+
+    destination->numEntries = source->numEntries;
+    destination->time = source->time;
+    destination->nextOrder = source->nextOrder;
+}
+
+// Give the unit a turn delay time units after the current turn.
+void ScheduleTurn(TurnScheduler* scheduler, int entity, int delay)
+{
+    if (scheduler->numEntries == scheduler->maxEntries)
+    {
+        scheduler->maxEntries = (scheduler->maxEntries == 0) ? 32 : scheduler->maxEntries * 2;
+        scheduler->entries = (TurnEntry*)MemRealloc(scheduler->entries, scheduler->maxEntries * sizeof(TurnEntry));
+    }
+
+    int index = scheduler->numEntries;
+    scheduler->numEntries++;
+
+    scheduler->entries[index].entity = entity;
+    scheduler->entries[index].time = scheduler->time + delay;
+    scheduler->entries[index].order = scheduler->nextOrder;
+    scheduler->nextOrder++;
+
+    while (index > 0)
+    {
+        int parent = (index - 1) / 2;
+
+        if (IsTurnBefore(&scheduler->entries[index], &scheduler->entries[parent]) == false)
+        {
+            break;
+        }
+
+        SwapTurnEntries(&scheduler->entries[index], &scheduler->entries[parent]);
+        index = parent;
+    }
+}
+
+// Remove the next living unit from the queue and advance time to its turn.
+// Returns ENTITY_NONE when no living unit is waiting.
+int PopNextTurn(TurnScheduler* scheduler, Entities* entities)
+{
+    while (scheduler->numEntries > 0)
+    {
+        TurnEntry next = scheduler->entries[0];
+
+        scheduler->numEntries--;
+        scheduler->entries[0] = scheduler->entries[scheduler->numEntries];
+        SiftTurnDown(scheduler->entries, scheduler->numEntries, 0);
+
+        if (entities->flags[next.entity] & ENTITY_FLAG_ALIVE)
+        {
+            scheduler->time = next.time;
+            return next.entity;
+        }
+    }
+
+    return ENTITY_NONE;
+}
+
+// Waiting units in turn order, dead units left out. Sorts a copy of the heap, meant for the
+// turn order display rather than for every simulation step.
+int GetTurnOrder(TurnScheduler* scheduler, Entities* entities, TurnEntry** entries)
+{
+    if (scheduler->numEntries > scheduler->maxSortedEntries)
+    {
+        scheduler->maxSortedEntries = scheduler->maxEntries;
+        scheduler->sortedEntries = (TurnEntry*)MemRealloc(scheduler->sortedEntries, scheduler->maxSortedEntries * sizeof(TurnEntry));
+    }
+
+    int numSorted = scheduler->numEntries;
+    TurnEntry* sorted = scheduler->sortedEntries;
+
+    for (int i = 0; i < numSorted; i++)
+    {
+        sorted[i] = scheduler->entries[i];
+    }
+
+    // Heap sort: keep popping the first entry to the end, then reverse.
+    for (int end = numSorted - 1; end > 0; end--)
+    {
+        SwapTurnEntries(&sorted[0], &sorted[end]);
+        SiftTurnDown(sorted, end, 0);
+    }
+
+    for (int i = 0; i < numSorted / 2; i++)
+    {
+        SwapTurnEntries(&sorted[i], &sorted[numSorted - 1 - i]);
+    }
+
+    int numAlive = 0;
+
+    for (int i = 0; i < numSorted; i++)
+    {
+        if (entities->flags[sorted[i].entity] & ENTITY_FLAG_ALIVE)
+        {
+            sorted[numAlive] = sorted[i];
+            numAlive++;
+        }
+    }
+
+    *entries = sorted;
+
+    return numAlive;
+}
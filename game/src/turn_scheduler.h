@@ -0,0 +1,37 @@
+#ifndef TURN_SCHEDULER_H
+#define TURN_SCHEDULER_H
+
+#include "entity.h"
+
+typedef struct TurnEntry
+{
+	int entity;
+	int time;					// Absolute time the unit acts at.
+	unsigned int order;			// Insertion order, breaks ties first come first served.
+
+} TurnEntry;
+
+// Initiative based turn order. Units wait in a min-heap keyed on the absolute time of their
+// next turn, so advancing time never has to touch the waiting units.
+typedef struct TurnScheduler
+{
+	TurnEntry* entries;
+	int numEntries;
+	int maxEntries;
+
+	TurnEntry* sortedEntries;	// Scratch buffer for GetTurnOrder().
+	int maxSortedEntries;
+
+	int time;					// Time of the current turn.
+	unsigned int nextOrder;
+
+} TurnScheduler;
+
+void UnloadTurnScheduler(TurnScheduler* scheduler);
+void CopyTurnScheduler(TurnScheduler* destination, const TurnScheduler* source);
+
+void ScheduleTurn(TurnScheduler* scheduler, int entity, int delay);
+int PopNextTurn(TurnScheduler* scheduler, Entities* entities);
+int GetTurnOrder(TurnScheduler* scheduler, Entities* entities, TurnEntry** entries);
+
+#endif
@@ -0,0 +1,41 @@
+
+baseName = path.getbasename(os.getcwd());
+
+project (baseName)
+    kind "ConsoleApp"
+    location "../_build"
+    targetdir "../_bin/%{cfg.buildcfg}"
+
+    filter "action:vs*"
+        debugdir "$(SolutionDir)"
+
+    filter{}
+
+    vpaths 
+    {
+        ["Header Files/*"] = { "src/**.h", "../game/src/**.h" },
+        ["Source Files/*"] = { "src/**.c", "../game/src/**.c" },
+    }
+    files {"src/**.c", "src/**.h"}
+
+    -- Battle logic shared with the game. None of it opens a window or touches the GPU.
+    files
+    {
+        "../game/src/action.c",
+        "../game/src/ai.c",
+        "../game/src/battle.c",
+        "../game/src/entity.c",
+        "../game/src/entity_grid.c",
+        "../game/src/level.c",
+        "../game/src/pathfinding.c",
+        "../game/src/replay.c",
+        "../game/src/rng.c",
+        "../game/src/thread_pool.c",
+        "../game/src/threads.c",
+        "../game/src/turn_scheduler.c",
+    }
+
+    includedirs { "src" }
+    includedirs { "../game/src" }
+
+    link_raylib()
@@ -0,0 +1,221 @@
+/**********************************************************************************************
+*
+*   Batch - Battles run in parallel
+*
+*   Every battle is one task on the thread pool. A battle only depends on its setup and
+*   seed, never on the worker that runs it, so results are the same for any thread count.
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+
+#include "batch.h"
+#include "ai.h"
+
+#include <stdlib.h>
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+#define MAX_LOADED_CHUNKS 64
+
+typedef struct BatchTask
+{
+    const BattleSetup* setups;
+    int battlesPerSetup;
+    unsigned int seed;
+    int maxTurns;
+
+    BatchStats* workerStats;        // One per worker, merged once all battles are done.
+    BattleResult* results;
+
+} BatchTask;
+
+//----------------------------------------------------------------------------------
+// Batch Functions Definition
+//----------------------------------------------------------------------------------
+// Run one AI versus AI battle. Adds the outcome to stats when stats is not NULL and records
+// the battle when recorder is not NULL.
+BattleResult RunBattle(const BattleSetup* setup, unsigned int seed, int maxTurns, BatchStats* stats, ReplayWriter* recorder)
+{
+    Battle battle = { 0 };
+    BattleResult result = { -1, 0 };
+    int unitEntities[BATTLE_TEAMS][TEAM_UNITS] = { 0 };
+
+    if (LoadBattle(&battle, BATCH_MAP_WIDTH, BATCH_MAP_HEIGHT, MAX_LOADED_CHUNKS, seed) == false)
+    {
+        return result;
+    }
+
+    battle.recorder = recorder;
+
+    SpawnBattleObject(&battle, 4, 3);
+    SpawnBattleObject(&battle, 1, 5);
+    SpawnBattleObject(&battle, 2, 2);
+
+    for (int team = 0; team < BATTLE_TEAMS; team++)
+    {
+        for (int i = 0; i < TEAM_UNITS; i++)
+        {
+            unitEntities[team][i] = SpawnBattleCharacter(&battle, team, &setup->units[team][i]);
+        }
+    }
+
+    // Entity ids back to the unit in the setup, for the per unit stats.
+    int* entityUnits = (int*)MemAlloc(battle.entities.numEntities * sizeof(int));
+
+    for (int i = 0; i < battle.entities.numEntities; i++)
+    {
+        entityUnits[i] = -1;
+    }
+
+    for (int team = 0; team < BATTLE_TEAMS; team++)
+    {
+        for (int i = 0; i < TEAM_UNITS; i++)
+        {
+            if (unitEntities[team][i] != ENTITY_NONE) entityUnits[unitEntities[team][i]] = team * TEAM_UNITS + i;
+        }
+    }
+
+    BeginBattle(&battle);
+
+    while (battle.isFinished == false && battle.numTurns < maxTurns)
+    {
+        Action action = { 0 };
+
+        if (setup->isSearchTeam[battle.entities.teamIDs[battle.activeEntity]]) action = ChooseSearchAction(&battle, (AiSearchLimits){ AI_MAX_DEPTH, BATCH_SEARCH_NODES, 0.0 });
+        else action = ChooseGreedyAction(&battle);
+
+        QueueBattleAction(&battle, action);
+
+        if (UpdateBattle(&battle) == 0)
+        {
+            action = (Action){ ACTION_WAIT, battle.activeEntity, -1, ENTITY_NONE };
+
+            QueueBattleAction(&battle, action);
+            UpdateBattle(&battle);
+        }
+
+        if (stats != NULL && action.type == ACTION_ATTACK_BASIC && entityUnits[action.entity] != -1)
+        {
+            int unit = entityUnits[action.entity];
+            UnitStats* unitStats = &stats->units[unit / TEAM_UNITS][unit % TEAM_UNITS];
+            int bucket = battle.lastDamage / DAMAGE_BUCKET_SIZE;
+
+            unitStats->numAttacks++;
+            unitStats->totalDamage += battle.lastDamage;
+            unitStats->damageHistogram[(bucket < DAMAGE_BUCKETS) ? bucket : DAMAGE_BUCKETS - 1]++;
+
+            if ((battle.entities.flags[action.target] & ENTITY_FLAG_ALIVE) == 0) unitStats->numKills++;
+        }
+    }
+
+    result.winner = battle.winner;
+    result.numTurns = battle.numTurns;
+
+    if (stats != NULL)
+    {
+        stats->numBattles++;
+        stats->totalTurns += battle.numTurns;
+
+        if (battle.winner == -1) stats->draws++;
+        else stats->wins[battle.winner]++;
+
+        for (int team = 0; team < BATTLE_TEAMS; team++)
+        {
+            for (int i = 0; i < TEAM_UNITS; i++)
+            {
+                int entity = unitEntities[team][i];
+
+                if (entity != ENTITY_NONE && (battle.entities.flags[entity] & ENTITY_FLAG_ALIVE)) stats->units[team][i].numSurvived++;
+            }
+        }
+    }
+
+    MemFree(entityUnits);
+    UnloadBattle(&battle);
+
+    return result;
+}
+
+static void MergeBatchStats(BatchStats* stats, const BatchStats* other)
+{
+    stats->numBattles += other->numBattles;
+    stats->draws += other->draws;
+    stats->totalTurns += other->totalTurns;
+
+    for (int team = 0; team < BATTLE_TEAMS; team++)
+    {
+        stats->wins[team] += other->wins[team];
+
+        for (int i = 0; i < TEAM_UNITS; i++)
+        {
+            UnitStats* unit = &stats->units[team][i];
+            const UnitStats* otherUnit = &other->units[team][i];
+
+            unit->numAttacks += otherUnit->numAttacks;
+            unit->totalDamage += otherUnit->totalDamage;
+            unit->numKills += otherUnit->numKills;
+            unit->numSurvived += otherUnit->numSurvived;
+
+            for (int j = 0; j < DAMAGE_BUCKETS; j++)
+            {
+                unit->damageHistogram[j] += otherUnit->damageHistogram[j];
+            }
+        }
+    }
+}
+
+static void RunBatchTask(void* data, int taskIndex, int workerIndex)
+{
+    BatchTask* task = (BatchTask*)data;
+    int setup = taskIndex / task->battlesPerSetup;
+    int battle = taskIndex % task->battlesPerSetup;
+
+    // Every setup plays the same seeds, differences between setups come from the stats only.
+    BatchStats* stats = (task->workerStats != NULL) ? &task->workerStats[workerIndex] : NULL;
+    BattleResult result = RunBattle(&task->setups[setup], task->seed + (unsigned int)battle, task->maxTurns, stats, NULL);
+
+    if (task->results != NULL)
+    {
+        task->results[taskIndex] = result;
+    }
+}
+
+// Run numBattles battles of one setup with seeds seed, seed + 1, ... and sum up the stats.
+void RunBatch(ThreadPool* pool, const BattleSetup* setup, int numBattles, unsigned int seed, int maxTurns, BatchStats* stats)
+{
+    int numWorkers = GetThreadPoolWorkers(pool);
+
+    BatchTask task = { 0 };
+    task.setups = setup;
+    task.battlesPerSetup = numBattles;
+    task.seed = seed;
+    task.maxTurns = maxTurns;
+    task.workerStats = (BatchStats*)MemAlloc(numWorkers * sizeof(BatchStats));
+
+    RunParallelFor(pool, numBattles, RunBatchTask, &task);
+
+    *stats = (BatchStats){ 0 };
+
+    for (int i = 0; i < numWorkers; i++)
+    {
+        MergeBatchStats(stats, &task.workerStats[i]);
+    }
+
+    MemFree(task.workerStats);
+}
+
+// Run battlesPerSetup battles for every setup. Results of setup i are stored at
+// results[i * battlesPerSetup].
+void RunSweep(ThreadPool* pool, const BattleSetup* setups, int numSetups, int battlesPerSetup, unsigned int seed, int maxTurns, BattleResult* results)
+{
+    BatchTask task = { 0 };
+    task.setups = setups;
+    task.battlesPerSetup = battlesPerSetup;
+    task.seed = seed;
+    task.maxTurns = maxTurns;
+    task.results = results;
+
+    RunParallelFor(pool, numSetups * battlesPerSetup, RunBatchTask, &task);
+}
@@ -0,0 +1,55 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "battle.h"
+#include "thread_pool.h"
+
+#define TEAM_UNITS 3
+#define BATCH_MAP_WIDTH 10
+#define BATCH_MAP_HEIGHT 8
+#define BATCH_SEARCH_NODES 2000		// Search AI nodes per turn, unlike time the same on any machine.
+
+#define DAMAGE_BUCKETS 16
+#define DAMAGE_BUCKET_SIZE 2		// Damage per histogram bucket, the last bucket is open ended.
+
+// Teams of one simulated battle.
+typedef struct BattleSetup
+{
+	UnitTemplate units[BATTLE_TEAMS][TEAM_UNITS];
+	bool isSearchTeam[BATTLE_TEAMS];	// Played by the search AI, other teams by the greedy AI.
+
+} BattleSetup;
+
+typedef struct BattleResult
+{
+	int winner;					// -1 for a draw.
+	int numTurns;
+
+} BattleResult;
+
+typedef struct UnitStats
+{
+	long long numAttacks;
+	long long totalDamage;
+	long long numKills;
+	long long numSurvived;		// Battles the unit was alive at the end of.
+	long long damageHistogram[DAMAGE_BUCKETS];
+
+} UnitStats;
+
+typedef struct BatchStats
+{
+	long long numBattles;
+	long long wins[BATTLE_TEAMS];
+	long long draws;
+	long long totalTurns;
+	UnitStats units[BATTLE_TEAMS][TEAM_UNITS];
+
+} BatchStats;
+
+BattleResult RunBattle(const BattleSetup* setup, unsigned int seed, int maxTurns, BatchStats* stats, ReplayWriter* recorder);
+
+void RunBatch(ThreadPool* pool, const BattleSetup* setup, int numBattles, unsigned int seed, int maxTurns, BatchStats* stats);
+void RunSweep(ThreadPool* pool, const BattleSetup* setups, int numSetups, int battlesPerSetup, unsigned int seed, int maxTurns, BattleResult* results);
+
+#endif
@@ -0,0 +1,404 @@
+/*******************************************************************************************
+*
+*   Battle simulator
+*
+*   Runs battles without a window, GPU or audio device, both teams controlled by the AI.
+*   Meant for balance testing and for checking that rule changes don't break battles.
+*
+*   Usage:
+*       simulator [battles] [seed] [maxTurns] [threads]
+*       simulator sweep <team> <unit> [battlesPerSetup] [seed] [threads]
+*       simulator search <team> [battles] [seed] [maxTurns] [threads]
+*       simulator record <file> [seed] [maxTurns]
+*       simulator replay <file> [turn]
+*       simulator terrain [size] [seed] [threads]
+*
+*   The sweep varies speed, initiative and attack of one unit and prints the win rate of
+*   its team for every combination as CSV. Search plays the team with the search AI against
+*   the greedy AI of the others. Replays are re-simulated as fast as possible,
+*   with a turn given only the state at the start of that turn is printed. Terrain generates
+*   a whole map and prints how long it took and how much of it each biome covers.
+*
+********************************************************************************************/
+
+#include "raylib.h"
+
+#include "batch.h"
+#include "replay.h"
+#include "threads.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+#define DEFAULT_BATTLES 1000
+#define DEFAULT_SWEEP_BATTLES 50
+#define DEFAULT_MAX_TURNS 500       // Battles still running after this many turns are draws.
+#define DEFAULT_TERRAIN_SIZE 1024
+
+#define SWEEP_MIN_SPEED 1
+#define SWEEP_MAX_SPEED 8
+#define SWEEP_MIN_INITIATIVE 1
+#define SWEEP_MAX_INITIATIVE 10
+#define SWEEP_MIN_ATTACK 4
+#define SWEEP_MAX_ATTACK 24
+#define SWEEP_ATTACK_STEP 4
+#define SWEEP_MAX_SPREAD 15         // Largest difference between max and min attack.
+#define SWEEP_SPREAD_STEP 5
+
+// Same teams as in the game.
+static const BattleSetup defaultSetup = {
+    {
+        {
+            { "Pasi", 4, 6, 80, 80, 6, 12 },
+            { "Kielo", 4, 6, 85, 85, 8, 14 },
+            { "Gandalf", 6, 4, 75, 75, 12, 22 },
+        },
+        {
+            { "Siqu", 2, 10, 80, 120, 5, 15 },
+            { "Bab", 3, 10, 130, 130, 16, 20 },
+            { "Sukellushitsaaja", 3, 2, 100, 100, 14, 18 },
+        },
+    }
+};
+
+//----------------------------------------------------------------------------------
+// Simulator Functions Definition
+//----------------------------------------------------------------------------------
+static void PrintBatchStats(const BatchStats* stats, const BattleSetup* setup)
+{
+    long long numBattles = (stats->numBattles > 0) ? stats->numBattles : 1;
+
+    for (int team = 0; team < BATTLE_TEAMS; team++)
+    {
+        printf("Team %d wins: %lld (%.1f%%)\n", team, stats->wins[team], 100.0 * stats->wins[team] / numBattles);
+    }
+
+    printf("Draws: %lld\n", stats->draws);
+    printf("Average turns: %.1f\n", (double)stats->totalTurns / numBattles);
+
+    for (int team = 0; team < BATTLE_TEAMS; team++)
+    {
+        for (int i = 0; i < TEAM_UNITS; i++)
+        {
+            const UnitStats* unit = &stats->units[team][i];
+            long long numAttacks = (unit->numAttacks > 0) ? unit->numAttacks : 1;
+
+            printf("\n%s (team %d)\n", setup->units[team][i].name, team);
+            printf("    Attacks per battle: %.2f, average damage %.2f\n", (double)unit->numAttacks / numBattles, (double)unit->totalDamage / numAttacks);
+            printf("    Kills per battle: %.2f, survived %.1f%%\n", (double)unit->numKills / numBattles, 100.0 * unit->numSurvived / numBattles);
+            printf("    Damage:");
+
+            for (int j = 0; j < DAMAGE_BUCKETS; j++)
+            {
+                if (unit->damageHistogram[j] == 0) continue;
+
+                if (j == DAMAGE_BUCKETS - 1) printf(" %d+: %lld", j * DAMAGE_BUCKET_SIZE, unit->damageHistogram[j]);
+                else printf(" %d-%d: %lld", j * DAMAGE_BUCKET_SIZE, (j + 1) * DAMAGE_BUCKET_SIZE - 1, unit->damageHistogram[j]);
+            }
+
+            printf("\n");
+        }
+    }
+}
+
+static void RunAndPrintBatch(const BattleSetup* setup, int numBattles, unsigned int seed, int maxTurns, int numThreads)
+{
+    ThreadPool* pool = LoadThreadPool(numThreads);
+    BatchStats stats = { 0 };
+
+    double startTime = GetMonotonicTime();
+    RunBatch(pool, setup, numBattles, seed, maxTurns, &stats);
+    double seconds = GetMonotonicTime() - startTime;
+
+    printf("Battles: %d (seeds %u - %u)\n", numBattles, seed, seed + (unsigned int)numBattles - 1);
+    PrintBatchStats(&stats, setup);
+    printf("\nTime: %.3f s (%.0f battles/s on %d threads)\n", seconds, (seconds > 0.0) ? numBattles / seconds : 0.0, GetThreadPoolWorkers(pool));
+
+    UnloadThreadPool(pool);
+}
+
+static int RunBatchCommand(int argc, char* argv[])
+{
+    int numBattles = (argc > 1) ? atoi(argv[1]) : DEFAULT_BATTLES;
+    unsigned int seed = (argc > 2) ? (unsigned int)strtoul(argv[2], NULL, 10) : 1;
+    int maxTurns = (argc > 3) ? atoi(argv[3]) : DEFAULT_MAX_TURNS;
+    int numThreads = (argc > 4) ? atoi(argv[4]) : 0;
+
+    RunAndPrintBatch(&defaultSetup, numBattles, seed, maxTurns, numThreads);
+
+    return 0;
+}
+
+static int RunSearchCommand(int argc, char* argv[])
+{
+    int team = (argc > 2) ? atoi(argv[2]) : -1;
+
+    if (team < 0 || team >= BATTLE_TEAMS)
+    {
+        fprintf(stderr, "Usage: simulator search <team> [battles] [seed] [maxTurns] [threads]\n");
+        return 1;
+    }
+
+    int numBattles = (argc > 3) ? atoi(argv[3]) : DEFAULT_BATTLES;
+    unsigned int seed = (argc > 4) ? (unsigned int)strtoul(argv[4], NULL, 10) : 1;
+    int maxTurns = (argc > 5) ? atoi(argv[5]) : DEFAULT_MAX_TURNS;
+    int numThreads = (argc > 6) ? atoi(argv[6]) : 0;
+
+    BattleSetup setup = defaultSetup;
+    setup.isSearchTeam[team] = true;
+
+    RunAndPrintBatch(&setup, numBattles, seed, maxTurns, numThreads);
+
+    return 0;
+}
+
+static int RunSweepCommand(int argc, char* argv[])
+{
+    if (argc < 4)
+    {
+        fprintf(stderr, "Usage: simulator sweep <team> <unit> [battlesPerSetup] [seed] [threads]\n");
+        return 1;
+    }
+
+    int team = atoi(argv[2]);
+    int unit = atoi(argv[3]);
+    int battlesPerSetup = (argc > 4) ? atoi(argv[4]) : DEFAULT_SWEEP_BATTLES;
+    unsigned int seed = (argc > 5) ? (unsigned int)strtoul(argv[5], NULL, 10) : 1;
+    int numThreads = (argc > 6) ? atoi(argv[6]) : 0;
+
+    if (team < 0 || team >= BATTLE_TEAMS || unit < 0 || unit >= TEAM_UNITS || battlesPerSetup <= 0)
+    {
+        fprintf(stderr, "Team has to be 0 - %d, unit 0 - %d\n", BATTLE_TEAMS - 1, TEAM_UNITS - 1);
+        return 1;
+    }
+
+    int maxSetups = (SWEEP_MAX_SPEED - SWEEP_MIN_SPEED + 1) * (SWEEP_MAX_INITIATIVE - SWEEP_MIN_INITIATIVE + 1) *
+        ((SWEEP_MAX_ATTACK - SWEEP_MIN_ATTACK) / SWEEP_ATTACK_STEP + 1) * (SWEEP_MAX_SPREAD / SWEEP_SPREAD_STEP + 1);
+    BattleSetup* setups = (BattleSetup*)MemAlloc(maxSetups * sizeof(BattleSetup));
+    int numSetups = 0;
+
+    for (int speed = SWEEP_MIN_SPEED; speed <= SWEEP_MAX_SPEED; speed++)
+    {
+        for (int initiative = SWEEP_MIN_INITIATIVE; initiative <= SWEEP_MAX_INITIATIVE; initiative++)
+        {
+            for (int minAttack = SWEEP_MIN_ATTACK; minAttack <= SWEEP_MAX_ATTACK; minAttack += SWEEP_ATTACK_STEP)
+            {
+                for (int spread = 0; spread <= SWEEP_MAX_SPREAD; spread += SWEEP_SPREAD_STEP)
+                {
+                    BattleSetup* setup = &setups[numSetups];
+                    *setup = defaultSetup;
+
+                    setup->units[team][unit].speed = speed;
+                    setup->units[team][unit].baseInitiative = initiative;
+                    setup->units[team][unit].minAttack = minAttack;
+                    setup->units[team][unit].maxAttack = minAttack + spread;
+                    numSetups++;
+                }
+            }
+        }
+    }
+
+    ThreadPool* pool = LoadThreadPool(numThreads);
+    BattleResult* results = (BattleResult*)MemAlloc(numSetups * battlesPerSetup * sizeof(BattleResult));
+
+    double startTime = GetMonotonicTime();
+    RunSweep(pool, setups, numSetups, battlesPerSetup, seed, DEFAULT_MAX_TURNS, results);
+    double seconds = GetMonotonicTime() - startTime;
+
+    printf("speed,initiative,minAttack,maxAttack,winRate,averageTurns\n");
+
+    for (int i = 0; i < numSetups; i++)
+    {
+        const UnitTemplate* template = &setups[i].units[team][unit];
+        int wins = 0;
+        long long totalTurns = 0;
+
+        for (int j = 0; j < battlesPerSetup; j++)
+        {
+            BattleResult* result = &results[i * battlesPerSetup + j];
+
+            if (result->winner == team) wins++;
+            totalTurns += result->numTurns;
+        }
+
+        printf("%d,%d,%d,%d,%.3f,%.1f\n", template->speed, template->baseInitiative, template->minAttack, template->maxAttack,
+            (double)wins / battlesPerSetup, (double)totalTurns / battlesPerSetup);
+    }
+
+    fprintf(stderr, "%d setups, %d battles in %.3f s on %d threads\n", numSetups, numSetups * battlesPerSetup, seconds, GetThreadPoolWorkers(pool));
+
+    MemFree(results);
+    MemFree(setups);
+    UnloadThreadPool(pool);
+
+    return 0;
+}
+
+static int RunRecordCommand(int argc, char* argv[])
+{
+    if (argc < 3)
+    {
+        fprintf(stderr, "Usage: simulator record <file> [seed] [maxTurns]\n");
+        return 1;
+    }
+
+    unsigned int seed = (argc > 3) ? (unsigned int)strtoul(argv[3], NULL, 10) : 1;
+    int maxTurns = (argc > 4) ? atoi(argv[4]) : DEFAULT_MAX_TURNS;
+    ReplayWriter writer = { 0 };
+
+    if (OpenReplayWriter(&writer, argv[2], seed, BATCH_MAP_WIDTH, BATCH_MAP_HEIGHT) == false)
+    {
+        return 1;
+    }
+
+    BattleResult result = RunBattle(&defaultSetup, seed, maxTurns, NULL, &writer);
+    int numRecords = writer.numRecords;
+
+    CloseReplayWriter(&writer);
+
+    printf("Winner: %d, turns: %d, records: %d\n", result.winner, result.numTurns, numRecords);
+
+    return 0;
+}
+
+static int RunReplayCommand(int argc, char* argv[])
+{
+    if (argc < 3)
+    {
+        fprintf(stderr, "Usage: simulator replay <file> [turn]\n");
+        return 1;
+    }
+
+    Replay replay = { 0 };
+    ReplayPlayer player = { 0 };
+
+    if (LoadReplay(&replay, argv[2]) == false)
+    {
+        fprintf(stderr, "Failed to load replay %s\n", argv[2]);
+        return 1;
+    }
+
+    if (LoadReplayPlayer(&player, &replay) == false)
+    {
+        UnloadReplay(&replay);
+        return 1;
+    }
+
+    double startTime = GetMonotonicTime();
+
+    if (argc > 3) SeekReplay(&player, atoi(argv[3]));
+    else while (StepReplay(&player));
+
+    double seconds = GetMonotonicTime() - startTime;
+
+    Battle* battle = &player.battle;
+    Entities* entities = &battle->entities;
+
+    printf("Seed: %u, map %dx%d, %d records\n", replay.seed, replay.width, replay.height, replay.numRecords);
+    printf("Turn: %d\n", battle->numTurns);
+
+    for (int i = 0; i < entities->numEntities; i++)
+    {
+        if (entities->types[i] != ENTITY_TYPE_CHARACTER) continue;
+
+        Tile* tile = GetEntityTile(battle, i);
+
+        printf("    %-20s team %d  health %3d/%-3d  tile %d,%d%s\n", entities->infos[i].name, entities->teamIDs[i],
+            entities->healths[i], entities->maxHealths[i], tile->x, tile->z, (entities->flags[i] & ENTITY_FLAG_ALIVE) ? "" : "  dead");
+    }
+
+    if (player.isDesynced) printf("Out of sync at record %d\n", player.record);
+    else if (battle->isFinished) printf("Winner: %d\n", battle->winner);
+    else printf("Not finished\n");
+
+    printf("Time: %.3f ms\n", seconds * 1000.0);
+
+    UnloadReplayPlayer(&player);
+    UnloadReplay(&replay);
+
+    return 0;
+}
+
+static int RunTerrainCommand(int argc, char* argv[])
+{
+    static const char* biomeNames[BIOME_COUNT] = { "Water", "Sand", "Grass", "Forest", "Rock" };
+
+    int size = (argc > 2) ? atoi(argv[2]) : DEFAULT_TERRAIN_SIZE;
+    unsigned int seed = (argc > 3) ? (unsigned int)strtoul(argv[3], NULL, 10) : 1;
+    int numThreads = (argc > 4) ? atoi(argv[4]) : 0;
+    Map map = { 0 };
+
+    if (LoadMap(&map, size, size, 0, seed) == false)
+    {
+        return 1;
+    }
+
+    ThreadPool* pool = LoadThreadPool(numThreads);
+
+    double startTime = GetMonotonicTime();
+    LoadMapChunks(&map, pool, 0, 0, map.chunksX - 1, map.chunksZ - 1);
+    double seconds = GetMonotonicTime() - startTime;
+
+    long long biomeTiles[BIOME_COUNT] = { 0 };
+
+    for (int z = 0; z < size; z++)
+    {
+        for (int x = 0; x < size; x++)
+        {
+            biomeTiles[GetMapTile(&map, x, z)->biome]++;
+        }
+    }
+
+    printf("Map: %dx%d, seed %u\n", size, size, seed);
+
+    for (int i = 0; i < BIOME_COUNT; i++)
+    {
+        printf("    %-8s %5.1f%%\n", biomeNames[i], 100.0 * biomeTiles[i] / ((long long)size * size));
+    }
+
+    printf("Time: %.3f s on %d threads\n", seconds, GetThreadPoolWorkers(pool));
+
+    UnloadThreadPool(pool);
+    UnloadMap(&map);
+
+    return 0;
+}
+
+//----------------------------------------------------------------------------------
+// Main entry point
+//----------------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+    SetTraceLogLevel(LOG_WARNING);
+
+    if (argc > 1 && strcmp(argv[1], "sweep") == 0)
+    {
+        return RunSweepCommand(argc, argv);
+    }
+
+    if (argc > 1 && strcmp(argv[1], "record") == 0)
+    {
+        return RunRecordCommand(argc, argv);
+    }
+
+    if (argc > 1 && strcmp(argv[1], "replay") == 0)
+    {
+        return RunReplayCommand(argc, argv);
+    }
+
+    if (argc > 1 && strcmp(argv[1], "search") == 0)
+    {
+        return RunSearchCommand(argc, argv);
+    }
+
+    if (argc > 1 && strcmp(argv[1], "terrain") == 0)
+    {
+        return RunTerrainCommand(argc, argv);
+    }
+
+    return RunBatchCommand(argc, argv);
+}